@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Summarize a binary event log of the noodler string solver.
+
+The log is produced by
+
+    z3 smt.string_solver=noodler smt.str.event_log=search.evt input.smt2
+
+and its format is described in src/smt/theory_str_noodler/event_log.h. The
+summary contains the time spent in each kind of event, the final checks, the
+shape of the search tree (rebuilt from the parent links of pushed solving
+states) and the most expensive noodlifications and inclusion checks.
+
+    python3 contrib/noodler_events/summarize_events.py search.evt --top 20
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+MAGIC = b"NOODLEV1"
+RECORD = struct.Struct("<QQIIIIIBBH")
+
+EVENT_NAMES = {
+    1: "final-check-begin",
+    2: "final-check-end",
+    3: "state-pop",
+    4: "state-push",
+    5: "inclusion-check",
+    6: "noodlification",
+    7: "length-check",
+    8: "blocking-lemma",
+}
+FINAL_CHECK_STATUS = {0: "done", 1: "continue", 2: "giveup"}
+
+Event = collections.namedtuple("Event", "time duration state parent size1 size2 size3 type result")
+
+
+def read_events(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:len(MAGIC)] != MAGIC:
+        sys.exit("%s is not a noodler event log" % path)
+    body = memoryview(data)[len(MAGIC):]
+    if len(body) % RECORD.size:
+        print("warning: truncated log, ignoring the last %d bytes" % (len(body) % RECORD.size), file=sys.stderr)
+    events = []
+    for off in range(0, len(body) - RECORD.size + 1, RECORD.size):
+        time, duration, state, parent, size1, size2, size3, typ, result, _ = RECORD.unpack_from(body, off)
+        events.append(Event(time, duration, state, parent, size1, size2, size3, EVENT_NAMES.get(typ, "unknown"),
+                            result))
+    return events
+
+
+def ms(ns):
+    return ns / 1e6
+
+
+def lbool_name(result):
+    # lbool is l_false = -1, l_undef = 0, l_true = 1, the log stores it as an unsigned byte
+    return {255: "unsat", 0: "unknown", 1: "sat"}.get(result, str(result))
+
+
+def summarize_types(events):
+    print("== events ==")
+    print("%-20s %10s %12s %12s %12s" % ("event", "count", "total [ms]", "mean [ms]", "max [ms]"))
+    by_type = collections.defaultdict(list)
+    for e in events:
+        by_type[e.type].append(e.duration)
+    for name in EVENT_NAMES.values():
+        durations = by_type.get(name)
+        if not durations:
+            continue
+        total = sum(durations)
+        print("%-20s %10d %12.3f %12.3f %12.3f" % (name, len(durations), ms(total), ms(total / len(durations)),
+                                                    ms(max(durations))))
+    if events:
+        print("trace length: %.3f ms" % ms(max(e.time + e.duration for e in events)))
+
+
+def summarize_final_checks(events, top):
+    checks = [e for e in events if e.type == "final-check-end"]
+    if not checks:
+        return
+    print("\n== final checks ==")
+    statuses = collections.Counter(FINAL_CHECK_STATUS.get(e.result, str(e.result)) for e in checks)
+    print("rounds: %d (%s)" % (len(checks), ", ".join("%s: %d" % kv for kv in sorted(statuses.items()))))
+    print("slowest rounds:")
+    for e in sorted(checks, key=lambda e: e.duration, reverse=True)[:top]:
+        print("  #%-6d %10.3f ms  %-8s length checks: %d" % (e.state, ms(e.duration),
+                                                           FINAL_CHECK_STATUS.get(e.result, e.result), e.size1))
+    lens = [e for e in events if e.type == "length-check"]
+    if lens:
+        results = collections.Counter(lbool_name(e.result) for e in lens)
+        print("length checks: %d (%s), %.3f ms in total" % (
+            len(lens), ", ".join("%s: %d" % kv for kv in sorted(results.items())), ms(sum(e.duration for e in lens))))
+    lemmas = [e for e in events if e.type == "blocking-lemma"]
+    if lemmas:
+        print("blocking lemmas: %d" % len(lemmas))
+
+
+def summarize_tree(events):
+    """
+    Rebuild the search trees. State ids are unique only within one run of the decision procedure (they restart
+    with every final check), so a new tree starts whenever the initial state (id 1 without a parent) is pushed.
+    """
+    trees = []
+    parent = None
+    popped = None
+    for e in events:
+        if e.type == "state-push":
+            if e.state == 1 and e.parent == 0:
+                parent, popped = {}, set()
+                trees.append((parent, popped))
+            if parent is not None:
+                parent.setdefault(e.state, e.parent)
+        elif e.type == "state-pop" and popped is not None:
+            popped.add(e.state)
+    if not trees:
+        return
+    print("\n== search trees ==")
+    sizes, depths, branching, unexplored = [], [], [], 0
+    for parent, popped in trees:
+        depth = {}
+
+        def get_depth(s):
+            d, path = 0, []
+            while s in parent and parent[s] != 0 and s not in depth:
+                path.append(s)
+                s = parent[s]
+            d = depth.get(s, 0)
+            for p in reversed(path):
+                d += 1
+                depth[p] = d
+            return d
+
+        depths.append(max((get_depth(s) for s in parent), default=0))
+        sizes.append(len(parent))
+        children = collections.Counter(p for p in parent.values() if p != 0)
+        branching.extend(children.values())
+        unexplored += len(set(parent) - popped)
+    print("trees: %d, states: %d (max %d per tree), never explored: %d" % (len(trees), sum(sizes), max(sizes),
+                                                                          unexplored))
+    print("max depth: %d, mean depth: %.2f" % (max(depths), sum(depths) / len(depths)))
+    if branching:
+        print("branching (noodles per expanded state): mean %.2f, max %d" % (sum(branching) / len(branching),
+                                                                           max(branching)))
+
+
+def summarize_hotspots(events, top):
+    noodlifications = [e for e in events if e.type == "noodlification"]
+    if noodlifications:
+        print("\n== slowest noodlifications ==")
+        print("%10s %8s %8s %8s %8s" % ("time [ms]", "state", "#left", "#right", "#noodles"))
+        for e in sorted(noodlifications, key=lambda e: e.duration, reverse=True)[:top]:
+            print("%10.3f %8d %8d %8d %8d" % (ms(e.duration), e.state, e.size1, e.size2, e.size3))
+    inclusions = [e for e in events if e.type == "inclusion-check"]
+    if inclusions:
+        holds = sum(1 for e in inclusions if e.result)
+        print("\n== slowest inclusion checks (%d of %d hold) ==" % (holds, len(inclusions)))
+        print("%10s %8s %12s %12s %6s" % ("time [ms]", "state", "left states", "right states", "holds"))
+        for e in sorted(inclusions, key=lambda e: e.duration, reverse=True)[:top]:
+            print("%10.3f %8d %12d %12d %6s" % (ms(e.duration), e.state, e.size1, e.size2, bool(e.result)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", help="event log written by z3 (smt.str.event_log)")
+    parser.add_argument("--top", type=int, default=10, help="number of hotspots to show")
+    args = parser.parse_args()
+
+    events = read_events(args.log)
+    print("%s: %d events" % (args.log, len(events)))
+    summarize_types(events)
+    summarize_final_checks(events, args.top)
+    summarize_tree(events)
+    summarize_hotspots(events, args.top)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,3 @@
+#!/usr/bin/env sh
+
+cd build/ && cmake ../ && make -j 4 bench-noodler-micro bench-noodler && ./bench-noodler-micro --reporter xml::out=bench-noodler-micro.xml
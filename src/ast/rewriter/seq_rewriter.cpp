@@ -401,6 +401,7 @@ eautomaton* re2automaton::seq2aut(expr* e) {
 void seq_rewriter::updt_params(params_ref const & p) {
     seq_rewriter_params sp(p);
     m_coalesce_chars = sp.coalesce_chars();
+    m_op_cache.ensure_max_size(sp.seq_op_cache_size());
 }
 
 void seq_rewriter::get_param_descrs(param_descrs & r) {
@@ -5995,33 +5996,3 @@ bool seq_rewriter::reduce_subsequence(expr_ref_vector& ls, expr_ref_vector& rs,
     }
     return true;
 } 
-
-seq_rewriter::op_cache::op_cache(ast_manager& m):
-    m_trail(m)
-{}
-
-expr* seq_rewriter::op_cache::find(decl_kind op, expr* a, expr* b, expr* c) {
-    op_entry e(op, a, b, c, nullptr);
-    m_table.find(e, e);
-
-    return e.r;
-}
-
-void seq_rewriter::op_cache::insert(decl_kind op, expr* a, expr* b, expr* c, expr* r) {
-    cleanup();
-    if (a) m_trail.push_back(a);
-    if (b) m_trail.push_back(b);
-    if (c) m_trail.push_back(c);
-    if (r) m_trail.push_back(r);
-    m_table.insert(op_entry(op, a, b, c, r));
-}
-
-void seq_rewriter::op_cache::cleanup() {
-    if (m_table.size() >= m_max_cache_size) {
-        m_trail.reset();
-        m_table.reset();
-        STRACE("seq_regex", tout << "Op cache reset!" << std::endl;);
-        STRACE("seq_regex_brief", tout << "(OP CACHE RESET) ";);
-        STRACE("seq_verbose", tout << "Derivative op cache reset" << std::endl;);
-    }
-}
@@ -19,6 +19,7 @@ Notes:
 #pragma once
 
 #include "ast/seq_decl_plugin.h"
+#include "ast/seq_op_cache.h"
 #include "ast/ast_pp.h"
 #include "ast/arith_decl_plugin.h"
 #include "ast/rewriter/rewriter_types.h"
@@ -114,44 +115,11 @@ public:
 */
 class seq_rewriter {
 
-    class op_cache {
-        struct op_entry {
-            decl_kind k;
-            expr* a, *b, *c, *r;
-            op_entry(decl_kind k, expr* a, expr* b, expr* c, expr* r): k(k), a(a), b(b), c(c), r(r) {}
-            op_entry():k(0), a(nullptr), b(nullptr), c(nullptr), r(nullptr) {}
-        };
-
-        struct hash_entry {
-            unsigned operator()(op_entry const& e) const { 
-                return combine_hash(mk_mix(e.k, e.a ? e.a->get_id() : 0, e.b ? e.b->get_id() : 0), e.c ? e.c->get_id() : 0);
-            }
-        };
-
-        struct eq_entry {
-            bool operator()(op_entry const& a, op_entry const& b) const {
-                return a.k == b.k && a.a == b.a && a.b == b.b && a.c == b.c;
-            }
-        };
-
-        typedef hashtable<op_entry, hash_entry, eq_entry> op_table;
-
-        unsigned        m_max_cache_size { 10000 };
-        expr_ref_vector m_trail;
-        op_table        m_table;
-        void cleanup();
-
-    public:
-        op_cache(ast_manager& m);
-        expr* find(decl_kind op, expr* a, expr* b, expr* c);
-        void insert(decl_kind op, expr* a, expr* b, expr* c, expr* r);
-    };
-
     seq_util       m_util;
     arith_util     m_autil;
     bool_rewriter  m_br;
     re2automaton   m_re2aut;
-    op_cache       m_op_cache;
+    seq_op_cache&  m_op_cache;
     expr_ref_vector m_es, m_lhs, m_rhs;
     bool           m_coalesce_chars;    
 
@@ -354,7 +322,7 @@ class seq_rewriter {
 
 public:
     seq_rewriter(ast_manager & m, params_ref const & p = params_ref()):
-        m_util(m), m_autil(m), m_br(m, p), m_re2aut(m), m_op_cache(m), m_es(m), 
+        m_util(m), m_autil(m), m_br(m, p), m_re2aut(m), m_op_cache(m_util.get_op_cache()), m_es(m), 
         m_lhs(m), m_rhs(m), m_coalesce_chars(true) {
     }
     ast_manager & m() const { return m_util.get_manager(); }
@@ -35,11 +35,25 @@ seq_decl_plugin::seq_decl_plugin(): m_init(false),
 void seq_decl_plugin::finalize() {
     for (psig* s : m_sigs) 
         dealloc(s);
+    m_op_cache = nullptr;
+    m_dfa_cache = nullptr;
     m_manager->dec_ref(m_string);
     m_manager->dec_ref(m_char);
     m_manager->dec_ref(m_reglan);
 }
 
+seq_op_cache& seq_decl_plugin::get_op_cache() {
+    if (!m_op_cache)
+        m_op_cache = alloc(seq_op_cache, *m_manager);
+    return *m_op_cache;
+}
+
+seq_dfa_cache& seq_decl_plugin::get_dfa_cache() {
+    if (!m_dfa_cache)
+        m_dfa_cache = alloc(seq_dfa_cache, *m_manager);
+    return *m_dfa_cache;
+}
+
 bool seq_decl_plugin::is_sort_param(sort* s, unsigned& idx) {
     return
         s->get_name().is_numerical() &&
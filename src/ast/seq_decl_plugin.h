@@ -24,6 +24,8 @@ Revision History:
 
 #include "ast/ast.h"
 #include "ast/char_decl_plugin.h"
+#include "ast/seq_dfa_cache.h"
+#include "ast/seq_op_cache.h"
 #include "util/lbool.h"
 #include "util/zstring.h"
 
@@ -139,6 +141,10 @@ class seq_decl_plugin : public decl_plugin {
     bool             m_has_re;
     bool             m_has_seq;
     char_decl_plugin* m_char_plugin { nullptr };
+    // regex operations memoized by the sequence rewriters of the manager
+    scoped_ptr<seq_op_cache> m_op_cache;
+    // automata of regexes explored by the sequence solvers of the manager
+    scoped_ptr<seq_dfa_cache> m_dfa_cache;
 
 
     void add_map_sig();
@@ -214,6 +220,10 @@ public:
 
     char_decl_plugin& get_char_plugin() const { return *m_char_plugin; }
 
+    seq_op_cache& get_op_cache();
+
+    seq_dfa_cache& get_dfa_cache();
+
 };
 
 class seq_util {
@@ -229,6 +239,9 @@ public:
 
     ast_manager& get_manager() const { return m; }
 
+    seq_op_cache& get_op_cache() const { return seq.get_op_cache(); }
+    seq_dfa_cache& get_dfa_cache() const { return seq.get_dfa_cache(); }
+
     sort* mk_char_sort() const { return seq.char_sort(); }
     sort* mk_string_sort() const { return seq.string_sort(); }
 
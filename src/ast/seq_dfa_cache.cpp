@@ -0,0 +1,91 @@
+/*++
+
+Module Name:
+
+    seq_dfa_cache.cpp
+
+Abstract:
+
+    Lazily constructed automata for regular expressions used by the sequence solver.
+
+--*/
+
+#include "ast/seq_dfa_cache.h"
+
+seq_dfa_cache::seq_dfa_cache(ast_manager& m):
+    m(m),
+    m_states(m),
+    m_conds(m),
+    m_targets(m) {}
+
+unsigned seq_dfa_cache::mk_state(expr* r) {
+    unsigned id = 0;
+    if (m_state2id.find(r, id))
+        return id;
+    if (m_states.size() >= m_max_states) {
+        reset();
+        ++m_stats.m_resets;
+    }
+    id = m_states.size();
+    m_states.push_back(r);
+    m_info.push_back(state_info());
+    m_state2id.insert(r, id);
+    ++m_stats.m_states;
+    return id;
+}
+
+bool seq_dfa_cache::find_transitions(expr* r, unsigned& begin, unsigned& end) {
+    unsigned id = 0;
+    if (m_state2id.find(r, id) && m_info[id].m_begin != UINT_MAX) {
+        ++m_stats.m_hits;
+        begin = m_info[id].m_begin;
+        end = m_info[id].m_end;
+        return true;
+    }
+    ++m_stats.m_misses;
+    return false;
+}
+
+bool seq_dfa_cache::is_unsupported(expr* r) const {
+    unsigned id = 0;
+    return m_state2id.find(r, id) && m_info[id].m_unsupported;
+}
+
+void seq_dfa_cache::set_transitions(expr* r, expr_ref_vector const& conds, expr_ref_vector const& targets) {
+    SASSERT(conds.size() == targets.size());
+    unsigned id = mk_state(r);
+    m_info[id].m_begin = m_conds.size();
+    m_conds.append(conds);
+    m_targets.append(targets);
+    m_info[id].m_end = m_conds.size();
+}
+
+void seq_dfa_cache::set_unsupported(expr* r) {
+    m_info[mk_state(r)].m_unsupported = true;
+}
+
+lbool seq_dfa_cache::get_status(expr* r) const {
+    unsigned id = 0;
+    if (m_state2id.find(r, id))
+        return m_info[id].m_status;
+    return l_undef;
+}
+
+void seq_dfa_cache::set_status(expr* r, lbool status) {
+    m_info[mk_state(r)].m_status = status;
+}
+
+void seq_dfa_cache::reset() {
+    m_state2id.reset();
+    m_states.reset();
+    m_info.reset();
+    m_conds.reset();
+    m_targets.reset();
+}
+
+void seq_dfa_cache::collect_statistics(statistics& st) const {
+    st.update("seq dfa hits", m_stats.m_hits);
+    st.update("seq dfa misses", m_stats.m_misses);
+    st.update("seq dfa states", m_stats.m_states);
+    st.update("seq dfa resets", m_stats.m_resets);
+}
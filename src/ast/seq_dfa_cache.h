@@ -0,0 +1,83 @@
+/*++
+
+Module Name:
+
+    seq_dfa_cache.h
+
+Abstract:
+
+    Lazily constructed automata for regular expressions used by the sequence solver.
+
+    States are regexes, interned by their hash-consed expression. The transitions
+    of a state are its minterm transitions: pairs of a character condition over
+    (:var 0) and the derivative of the state for the characters satisfying the
+    condition. States also record whether they are known to be live (accept some
+    word) or dead (accept no word).
+
+    The cache is owned by the sequence plugin, so automata built by one solver are
+    reused by later solvers and check-sat calls over the same ast_manager. Only
+    properties of the regex itself are stored, so the entries do not depend on the
+    solver context. The cache is cleared when it exceeds its capacity.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/lbool.h"
+#include "util/obj_hashtable.h"
+#include "util/statistics.h"
+
+class seq_dfa_cache {
+    struct state_info {
+        unsigned m_begin { UINT_MAX };  // transitions are [m_begin, m_end) in m_conds/m_targets
+        unsigned m_end { UINT_MAX };
+        bool     m_unsupported { false };
+        lbool    m_status { l_undef };  // l_true: live, l_false: dead
+    };
+
+    struct stats {
+        unsigned m_hits, m_misses, m_states, m_resets;
+        void reset() { memset(this, 0, sizeof(stats)); }
+        stats() { reset(); }
+    };
+
+    ast_manager&            m;
+    obj_map<expr, unsigned> m_state2id;
+    expr_ref_vector         m_states;
+    svector<state_info>     m_info;
+    expr_ref_vector         m_conds;
+    expr_ref_vector         m_targets;
+    unsigned                m_max_states { 100000 };
+    stats                   m_stats;
+
+    unsigned mk_state(expr* r);
+
+public:
+    seq_dfa_cache(ast_manager& m);
+
+    /*
+       Return true if the transitions of r are known and set [begin, end)
+       to their range, see get_cond and get_target.
+    */
+    bool find_transitions(expr* r, unsigned& begin, unsigned& end);
+    /*
+       Return true if r was found to have no minterm transitions
+       (non-character elements or conditions that are not character ranges).
+    */
+    bool is_unsupported(expr* r) const;
+
+    expr* get_cond(unsigned i) const { return m_conds.get(i); }
+    expr* get_target(unsigned i) const { return m_targets.get(i); }
+
+    void set_transitions(expr* r, expr_ref_vector const& conds, expr_ref_vector const& targets);
+    void set_unsupported(expr* r);
+
+    lbool get_status(expr* r) const;
+    void set_status(expr* r, lbool status);
+
+    void reset();
+    unsigned size() const { return m_states.size(); }
+    void set_max_states(unsigned n) { m_max_states = n; }
+
+    void collect_statistics(statistics& st) const;
+};
@@ -0,0 +1,99 @@
+/*++
+
+Module Name:
+
+    seq_op_cache.cpp
+
+Abstract:
+
+    Cache of regex derivatives and other regex operations computed by seq_rewriter.
+
+--*/
+
+#include <algorithm>
+#include "ast/seq_op_cache.h"
+
+seq_op_cache::seq_op_cache(ast_manager& m): m(m) {}
+
+seq_op_cache::~seq_op_cache() {
+    reset();
+}
+
+void seq_op_cache::inc_ref(op_entry const& e) {
+    m.inc_ref(e.a);
+    m.inc_ref(e.b);
+    m.inc_ref(e.c);
+    m.inc_ref(e.r);
+}
+
+void seq_op_cache::dec_ref(op_entry const& e) {
+    m.dec_ref(e.a);
+    m.dec_ref(e.b);
+    m.dec_ref(e.c);
+    m.dec_ref(e.r);
+}
+
+expr* seq_op_cache::find(decl_kind op, expr* a, expr* b, expr* c) {
+    op_table::entry* e = m_table.find_core(op_entry(op, a, b, c, nullptr));
+    if (!e) {
+        ++m_stats.m_misses;
+        return nullptr;
+    }
+    ++m_stats.m_hits;
+    e->get_data().last_use = ++m_clock;
+    return e->get_data().r;
+}
+
+void seq_op_cache::insert(decl_kind op, expr* a, expr* b, expr* c, expr* r) {
+    op_entry n(op, a, b, c, r);
+    n.last_use = ++m_clock;
+    op_table::entry* e = m_table.find_core(n);
+    if (e) {
+        m.inc_ref(r);
+        m.dec_ref(e->get_data().r);
+        e->get_data().r = r;
+        e->get_data().last_use = n.last_use;
+        return;
+    }
+    if (m_table.size() >= m_max_size)
+        evict();
+    inc_ref(n);
+    m_table.insert(n);
+    ++m_stats.m_inserts;
+}
+
+/**
+   \brief Remove the least recently used half of the entries.
+*/
+void seq_op_cache::evict() {
+    svector<uint64_t> uses;
+    for (op_entry const& e : m_table)
+        uses.push_back(e.last_use);
+    auto mid = uses.begin() + uses.size() / 2;
+    std::nth_element(uses.begin(), mid, uses.end());
+    uint64_t threshold = *mid;
+    svector<op_entry> old;
+    for (op_entry const& e : m_table)
+        if (e.last_use < threshold)
+            old.push_back(e);
+    for (op_entry const& e : old) {
+        m_table.remove(e);
+        dec_ref(e);
+    }
+    m_stats.m_evictions += old.size();
+    STRACE("seq_regex", tout << "Op cache evicted " << old.size() << " entries" << std::endl;);
+}
+
+void seq_op_cache::reset() {
+    for (op_entry const& e : m_table)
+        dec_ref(e);
+    m_table.reset();
+}
+
+void seq_op_cache::collect_statistics(statistics& st) const {
+    st.update("seq op cache hits", m_stats.m_hits);
+    st.update("seq op cache misses", m_stats.m_misses);
+    st.update("seq op cache inserts", m_stats.m_inserts);
+    st.update("seq op cache evictions", m_stats.m_evictions);
+    st.update("seq op cache size", m_table.size());
+}
@@ -0,0 +1,76 @@
+/*++
+
+Module Name:
+
+    seq_op_cache.h
+
+Abstract:
+
+    Cache of regex derivatives and other regex operations computed by seq_rewriter.
+
+    The cache is owned by the sequence plugin, so it is shared by all rewriters
+    over the same ast_manager and outlives the individual rewriters (th_rewriter
+    instances of tactics, theory solvers, ...). Entries keep references to their
+    arguments and results. When the cache exceeds its capacity, the least
+    recently used half of the entries is evicted.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/hashtable.h"
+#include "util/statistics.h"
+
+class seq_op_cache {
+    struct op_entry {
+        decl_kind k;
+        expr* a, *b, *c, *r;
+        uint64_t last_use;
+        op_entry(decl_kind k, expr* a, expr* b, expr* c, expr* r): k(k), a(a), b(b), c(c), r(r), last_use(0) {}
+        op_entry():k(0), a(nullptr), b(nullptr), c(nullptr), r(nullptr), last_use(0) {}
+    };
+
+    struct hash_entry {
+        unsigned operator()(op_entry const& e) const {
+            return combine_hash(mk_mix(e.k, e.a ? e.a->get_id() : 0, e.b ? e.b->get_id() : 0), e.c ? e.c->get_id() : 0);
+        }
+    };
+
+    struct eq_entry {
+        bool operator()(op_entry const& a, op_entry const& b) const {
+            return a.k == b.k && a.a == b.a && a.b == b.b && a.c == b.c;
+        }
+    };
+
+    typedef hashtable<op_entry, hash_entry, eq_entry> op_table;
+
+    struct stats {
+        unsigned m_hits, m_misses, m_inserts, m_evictions;
+        void reset() { memset(this, 0, sizeof(stats)); }
+        stats() { reset(); }
+    };
+
+    ast_manager&    m;
+    op_table        m_table;
+    unsigned        m_max_size { 100000 };
+    uint64_t        m_clock { 0 };
+    stats           m_stats;
+
+    void inc_ref(op_entry const& e);
+    void dec_ref(op_entry const& e);
+    void evict();
+
+public:
+    seq_op_cache(ast_manager& m);
+    ~seq_op_cache();
+
+    expr* find(decl_kind op, expr* a, expr* b, expr* c);
+    void insert(decl_kind op, expr* a, expr* b, expr* c, expr* r);
+    void reset();
+
+    unsigned size() const { return m_table.size(); }
+    // capacity requested by one of the rewriters sharing the cache, the largest request wins
+    void ensure_max_size(unsigned n) { m_max_size = std::max(m_max_size, n); }
+
+    void collect_statistics(statistics& st) const;
+};
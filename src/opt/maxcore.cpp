@@ -1062,6 +1062,8 @@ public:
         m_enable_core_rotate =      p.enable_core_rotate();
         m_lns_conflicts =           p.lns_conflicts();
         m_use_totalizer =           p.rc2_totalizer();
+        m_mus.set_num_threads(p.maxres_mus_threads());
+        m_mus.set_budget(p.maxres_mus_budget());
 	if (m_c.num_objectives() > 1)
 	  m_add_upper_bound_block = false;
     }
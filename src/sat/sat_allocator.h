@@ -89,6 +89,13 @@ public:
         }
     }
     size_t get_allocation_size() const { return m_alloc_size; }
+    // memory held by chunks and the part of it that is in free lists.
+    size_t get_reserved_size() const { return m_chunks.size() * CHUNK_SIZE; }
+    size_t get_free_size() const {
+        size_t sz = 0;
+        for (unsigned i = 0; i < NUM_FREE; ++i) sz += m_free[i].size() * (static_cast<size_t>(i) << PTR_ALIGNMENT);
+        return sz;
+    }
 
     char const* id() const { return m_id; }
 };
@@ -142,6 +142,8 @@ namespace sat {
         clause_allocator();
         void          finalize();
         size_t        get_allocation_size() const { return m_allocator.get_allocation_size(); }
+        size_t        get_reserved_size() const { return m_allocator.get_reserved_size(); }
+        size_t        get_free_size() const { return m_allocator.get_free_size(); }
         clause *      get_clause(clause_offset cls_off) const;
         clause_offset get_offset(clause const * ptr) const;
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
@@ -0,0 +1,343 @@
+/*++
+
+  Module Name:
+
+   sat_clause_cache.cpp
+
+  Abstract:
+
+    Cache of learned clauses across runs.
+
+  --*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "sat/sat_clause_cache.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    static uint64_t mix64(uint64_t h, uint64_t x) {
+        uint64_t z = h ^ (x + 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    clause_cache::clause_cache(solver& s, std::string const& file):
+        s(s), m_file(file) {}
+
+    void clause_cache::name(bool_var v) {
+        if (m_var2norm[v] != UINT_MAX)
+            return;
+        m_var2norm[v] = m_norm2var.size();
+        m_norm2var.push_back(v);
+    }
+
+    unsigned clause_cache::normalize(literal lit) const {
+        return 2 * m_var2norm[lit.var()] + lit.sign();
+    }
+
+    literal clause_cache::denormalize(unsigned lit) const {
+        unsigned v = lit >> 1;
+        if (v >= m_norm2var.size())
+            return null_literal;
+        return literal(m_norm2var[v], (lit & 1) != 0);
+    }
+
+    /**
+       \brief Rename the variables in the order of their first occurrence in the clauses,
+       followed by the binary clauses reachable from named variables, and compute the
+       fingerprint over the renamed clauses. Binary clauses and units are hashed
+       independently of their order.
+    */
+    void clause_cache::init_key() {
+        m_num_vars = s.num_vars();
+        m_var2norm.reset();
+        m_var2norm.resize(m_num_vars, UINT_MAX);
+        m_norm2var.reset();
+        for (clause* c : s.m_clauses)
+            for (literal lit : *c)
+                name(lit.var());
+        for (unsigned i = 0; i < m_norm2var.size(); ++i) {
+            bool_var v = m_norm2var[i];
+            for (literal lit : { literal(v, false), literal(v, true) })
+                for (watched const& w : s.m_watches[(~lit).index()])
+                    if (w.is_binary_non_learned_clause())
+                        name(w.get_literal().var());
+        }
+        for (bool_var v = 0; v < m_num_vars; ++v)
+            name(v);
+
+        uint64_t h = mix64(0, m_num_vars);
+        for (clause* c : s.m_clauses) {
+            h = mix64(h, c->size());
+            for (literal lit : *c)
+                h = mix64(h, normalize(lit));
+        }
+        uint64_t bins = 0, units = 0;
+        unsigned num_bins = 0;
+        unsigned sz = s.m_watches.size();
+        for (unsigned l_idx = 0; l_idx < sz; ++l_idx) {
+            literal l1 = ~to_literal(l_idx);
+            for (watched const& w : s.m_watches[l_idx]) {
+                if (!w.is_binary_non_learned_clause())
+                    continue;
+                literal l2 = w.get_literal();
+                if (l1.index() > l2.index())
+                    continue;
+                unsigned a = normalize(l1), b = normalize(l2);
+                bins += mix64(std::min(a, b), std::max(a, b));
+                ++num_bins;
+            }
+        }
+        unsigned trail_sz = s.init_trail_size();
+        for (unsigned i = 0; i < trail_sz; ++i)
+            units += mix64(1, normalize(s.m_trail[i]));
+        h = mix64(h, num_bins);
+        h = mix64(h, bins);
+        h = mix64(h, trail_sz);
+        m_key = mix64(h, units);
+    }
+
+    static uint64_t checksum(uint64_t key, unsigned num_vars, unsigned num_clauses, unsigned_vector const& data) {
+        uint64_t h = mix64(key, num_vars);
+        h = mix64(h, num_clauses);
+        for (unsigned x : data)
+            h = mix64(h, x);
+        return h;
+    }
+
+    bool clause_cache::read_records(vector<record>& records) const {
+        std::ifstream in(m_file, std::ios::binary);
+        if (!in)
+            return false;
+        auto read32 = [&](unsigned& x) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&x), sizeof(x))); };
+        auto read64 = [&](uint64_t& x) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&x), sizeof(x))); };
+        unsigned magic = 0, version = 0;
+        if (!read32(magic) || !read32(version) || magic != c_magic || version != c_version) {
+            IF_VERBOSE(1, verbose_stream() << "(sat.clause-cache ignoring " << m_file << ": unknown format)\n";);
+            return false;
+        }
+        record r;
+        while (read64(r.m_key)) {
+            r.m_data.reset();
+            uint64_t chk = 0;
+            if (!read32(r.m_num_vars) || !read32(r.m_num_clauses))
+                return false;
+            for (unsigned i = 0; i < r.m_num_clauses; ++i) {
+                unsigned sz = 0, glue = 0, lit = 0;
+                if (!read32(sz) || !read32(glue) || sz == 0 || sz > (1u << 16))
+                    return false;
+                r.m_data.push_back(sz);
+                r.m_data.push_back(glue);
+                for (unsigned j = 0; j < sz; ++j) {
+                    if (!read32(lit))
+                        return false;
+                    r.m_data.push_back(lit);
+                }
+            }
+            if (!read64(chk))
+                return false;
+            if (chk != checksum(r.m_key, r.m_num_vars, r.m_num_clauses, r.m_data)) {
+                IF_VERBOSE(1, verbose_stream() << "(sat.clause-cache ignoring corrupted record in " << m_file << ")\n";);
+                continue;
+            }
+            records.push_back(r);
+        }
+        return true;
+    }
+
+    bool clause_cache::write_records(vector<record> const& records) const {
+        std::string tmp = m_file + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            auto write32 = [&](unsigned x) { out.write(reinterpret_cast<char const*>(&x), sizeof(x)); };
+            auto write64 = [&](uint64_t x) { out.write(reinterpret_cast<char const*>(&x), sizeof(x)); };
+            write32(c_magic);
+            write32(c_version);
+            for (record const& r : records) {
+                write64(r.m_key);
+                write32(r.m_num_vars);
+                write32(r.m_num_clauses);
+                for (unsigned x : r.m_data)
+                    write32(x);
+                write64(checksum(r.m_key, r.m_num_vars, r.m_num_clauses, r.m_data));
+            }
+            out.close();
+            if (!out)
+                return false;
+        }
+        // rename replaces the file atomically on POSIX systems, other systems require removing it first.
+        if (std::rename(tmp.c_str(), m_file.c_str()) != 0) {
+            std::remove(m_file.c_str());
+            if (std::rename(tmp.c_str(), m_file.c_str()) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+       \brief Check whether the clause follows from the clauses of the solver by unit propagation.
+    */
+    bool clause_cache::is_rup(literal_vector const& c) {
+        SASSERT(s.at_base_lvl());
+        s.push();
+        for (literal lit : c) {
+            if (s.inconsistent())
+                break;
+            if (s.value(lit) == l_undef)
+                s.assign_scoped(~lit);
+        }
+        if (!s.inconsistent())
+            s.propagate(false);
+        bool r = s.inconsistent();
+        s.pop(1);
+        return r;
+    }
+
+    /**
+       \brief Add the cached clauses of the current fingerprint that follow by unit propagation.
+       A clause may only follow from clauses learned after it, so rejected clauses are
+       retried as long as new clauses are added.
+    */
+    void clause_cache::load() {
+        if (m_initialized)
+            return;
+        m_initialized = true;
+        SASSERT(s.at_base_lvl());
+        init_key();
+        vector<record> records;
+        if (!read_records(records))
+            return;
+        unsigned_vector pending, next;   // (size, glue, literals) of clauses to validate
+        literal_vector c;
+        for (record const& r : records) {
+            if (r.m_key != m_key || r.m_num_vars != m_num_vars)
+                continue;
+            unsigned_vector const& data = r.m_data;
+            for (unsigned i = 0; i < data.size(); i += 2 + data[i]) {
+                unsigned sz = data[i];
+                bool ok = true;
+                c.reset();
+                for (unsigned j = 0; j < sz && ok; ++j) {
+                    literal lit = denormalize(data[i + 2 + j]);
+                    ok = lit != null_literal && !s.was_eliminated(lit.var()) && !c.contains(~lit);
+                    if (ok && !c.contains(lit))
+                        c.push_back(lit);
+                }
+                if (!ok) {
+                    ++m_stats.m_rejected;
+                    continue;
+                }
+                pending.push_back(c.size());
+                pending.push_back(data[i + 1]);
+                for (literal lit : c)
+                    pending.push_back(lit.index());
+            }
+        }
+
+        bool progress = true;
+        while (progress && !pending.empty() && !s.inconsistent()) {
+            progress = false;
+            next.reset();
+            for (unsigned i = 0; i < pending.size() && !s.inconsistent(); i += 2 + pending[i]) {
+                unsigned sz = pending[i], glue = pending[i + 1];
+                bool is_sat = false;
+                c.reset();
+                for (unsigned j = 0; j < sz && !is_sat; ++j) {
+                    literal lit = to_literal(pending[i + 2 + j]);
+                    is_sat = s.value(lit) == l_true;
+                    if (s.value(lit) == l_undef)
+                        c.push_back(lit);
+                }
+                if (is_sat)
+                    continue;
+                if (c.empty() || !is_rup(c)) {
+                    next.append(2 + sz, pending.data() + i);
+                    continue;
+                }
+                clause* cls = s.mk_clause_core(c.size(), c.data(), sat::status::redundant());
+                if (cls)
+                    cls->set_glue(glue);
+                if (c.size() == 1)
+                    s.propagate(false);
+                ++m_stats.m_loaded;
+                progress = true;
+            }
+            pending.swap(next);
+        }
+        for (unsigned i = 0; i < pending.size(); i += 2 + pending[i])
+            ++m_stats.m_rejected;
+        IF_VERBOSE(2, verbose_stream() << "(sat.clause-cache :loaded " << m_stats.m_loaded << " :rejected " << m_stats.m_rejected << ")\n";);
+    }
+
+    void clause_cache::save() {
+        if (!m_initialized || !m_valid)
+            return;
+        config const& cfg = s.get_config();
+        record rec;
+        rec.m_key = m_key;
+        rec.m_num_vars = m_num_vars;
+        auto add = [&](unsigned sz, literal const* lits, unsigned glue) {
+            if (rec.m_num_clauses >= cfg.m_learned_cache_max_clauses)
+                return;
+            for (unsigned i = 0; i < sz; ++i)
+                if (lits[i].var() >= m_num_vars || s.was_eliminated(lits[i].var()))
+                    return;
+            rec.m_data.push_back(sz);
+            rec.m_data.push_back(glue);
+            for (unsigned i = 0; i < sz; ++i)
+                rec.m_data.push_back(normalize(lits[i]));
+            ++rec.m_num_clauses;
+        };
+
+        unsigned trail_sz = s.init_trail_size();
+        for (unsigned i = 0; i < trail_sz; ++i)
+            add(1, s.m_trail.data() + i, 1);
+        unsigned sz = s.m_watches.size();
+        for (unsigned l_idx = 0; l_idx < sz; ++l_idx) {
+            literal l1 = ~to_literal(l_idx);
+            for (watched const& w : s.m_watches[l_idx]) {
+                if (!w.is_binary_learned_clause() || l1.index() > w.get_literal().index())
+                    continue;
+                literal lits[2] = { l1, w.get_literal() };
+                add(2, lits, 2);
+            }
+        }
+        ptr_vector<clause> learned;
+        for (clause* c : s.m_learned)
+            if (!c->was_removed() && c->size() <= cfg.m_learned_cache_max_size && c->glue() <= cfg.m_learned_cache_max_glue)
+                learned.push_back(c);
+        std::stable_sort(learned.begin(), learned.end(), [](clause const* a, clause const* b) {
+            return a->glue() < b->glue() || (a->glue() == b->glue() && a->size() < b->size());
+        });
+        for (clause* c : learned)
+            add(c->size(), c->begin(), c->glue());
+
+        // keep the most recent records of other problems.
+        vector<record> records, keep;
+        read_records(records);
+        unsigned num_other = 0;
+        for (record const& r : records)
+            num_other += r.m_key != m_key;
+        for (record const& r : records)
+            if (r.m_key != m_key && num_other-- < c_max_records)
+                keep.push_back(r);
+        keep.push_back(rec);
+        if (!write_records(keep)) {
+            IF_VERBOSE(1, verbose_stream() << "(sat.clause-cache could not write " << m_file << ")\n";);
+            return;
+        }
+        m_stats.m_saved = rec.m_num_clauses;
+    }
+
+    void clause_cache::collect_statistics(statistics& st) const {
+        st.update("sat clause cache loaded", m_stats.m_loaded);
+        st.update("sat clause cache rejected", m_stats.m_rejected);
+        st.update("sat clause cache saved", m_stats.m_saved);
+    }
+}
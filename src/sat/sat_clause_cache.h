@@ -0,0 +1,100 @@
+/*++
+
+  Module Name:
+
+   sat_clause_cache.h
+
+  Abstract:
+
+    Cache of learned clauses across runs.
+
+    Short learned clauses with low glue are written to a file when the
+    owner of the solver calls solver::save_clause_cache, keyed by a
+    fingerprint of the input clauses.
+    Variables are renamed in the order of their first occurrence in the
+    input clauses, so the fingerprint and the stored clauses do not depend
+    on the numbering of the variables. Nothing is written if input clauses
+    were added after the fingerprint was computed.
+
+    When a solver with the same fingerprint starts its first search, the
+    stored clauses are mapped back to its variables and each one is
+    validated by unit propagation (RUP) against the clauses of the solver
+    before it is added as a learned clause. A stale or corrupted cache can
+    therefore only cost time, not soundness.
+
+    File layout: a header, followed by records of the form
+      key, number of variables, number of clauses,
+      (size, glue, literals) for each clause, checksum.
+    All values are stored as 32-bit unsigned integers, except for the
+    key and the checksum which use 64 bits, in the byte order of the host.
+
+  --*/
+#pragma once
+
+#include <string>
+#include "util/statistics.h"
+#include "sat/sat_types.h"
+
+namespace sat {
+    class solver;
+
+    class clause_cache {
+        struct stats {
+            unsigned m_loaded, m_rejected, m_saved;
+            void reset() { memset(this, 0, sizeof(*this)); }
+            stats() { reset(); }
+        };
+
+        struct record {
+            uint64_t        m_key { 0 };
+            unsigned        m_num_vars { 0 };
+            unsigned_vector m_data;        // (size, glue, literals) for each clause
+            unsigned        m_num_clauses { 0 };
+        };
+
+        solver&         s;
+        std::string     m_file;
+        uint64_t        m_key { 0 };
+        unsigned        m_num_vars { 0 };
+        bool            m_initialized { false };
+        bool            m_valid { true };  // the input clauses still match the key
+        unsigned_vector m_var2norm;        // variable -> normalized variable, UINT_MAX if not named
+        bool_var_vector m_norm2var;
+        stats           m_stats;
+
+        static const unsigned c_magic = 0x434c335a; // "Z3LC"
+        static const unsigned c_version = 1;
+        static const unsigned c_max_records = 16;
+
+        void init_key();
+        void name(bool_var v);
+        unsigned normalize(literal lit) const;
+        literal denormalize(unsigned lit) const;
+        bool read_records(vector<record>& records) const;
+        bool write_records(vector<record> const& records) const;
+        bool is_rup(literal_vector const& c);
+
+    public:
+        clause_cache(solver& s, std::string const& file);
+
+        /**
+           \brief Add the validated clauses cached for the current input clauses.
+           Called at base level before the first search.
+        */
+        void load();
+
+        /**
+           \brief Store the short learned clauses of the solver under the fingerprint
+           computed by load, unless input clauses were added since.
+        */
+        void save();
+
+        /**
+           \brief Input clauses were added after load, the fingerprint no longer
+           describes the clauses of the solver.
+        */
+        void invalidate() { if (m_initialized) m_valid = false; }
+
+        void collect_statistics(statistics& st) const;
+    };
+}
@@ -124,6 +124,14 @@ namespace sat {
         
         iterator mk_iterator() const { return iterator(const_cast<clause_use_list*>(this)->m_clauses); }
 
+        // iterate without compressing, so it can be used by concurrent readers.
+        template<typename F>
+        void for_each(F const& f) const {
+            for (clause* c : m_clauses) 
+                if (!c->was_removed()) 
+                    f(*c);
+        }
+
         std::ostream& display(std::ostream& out) const {
             iterator it = mk_iterator();
             while (!it.at_end()) {
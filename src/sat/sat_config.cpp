@@ -21,6 +21,7 @@ Revision History:
 #include "sat/sat_params.hpp"
 #include "sat/sat_simplifier_params.hpp"
 #include "params/solver_params.hpp"
+#include "util/gparams.h"
 
 
 namespace sat {
@@ -94,6 +95,9 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_threads     = p.threads();
+        m_par_share_glue  = p.threads_share_glue();
+        m_par_share_size  = p.threads_share_size();
+        m_par_share_batch = p.threads_share_batch();
         m_ddfw_search     = p.ddfw_search();
         m_ddfw_threads    = p.ddfw_threads();
         m_prob_search     = p.prob_search();
@@ -106,6 +110,8 @@ namespace sat {
         m_local_search_dbg_flips = p.local_search_dbg_flips();
         //m_binspr            = p.binspr();
         m_binspr            = false;     // prevent adventurous users from trying feature that isn't ready
+        m_vivify            = p.vivify();
+        m_vivify_limit      = p.vivify_limit();
         m_anf_simplify      = p.anf();
         m_anf_delay         = p.anf_delay();
         m_anf_exlin         = p.anf_exlin();
@@ -177,15 +183,23 @@ namespace sat {
             m_gc_strategy = GC_PSM;
         else if (s == symbol("psm_glue"))
             m_gc_strategy = GC_PSM_GLUE;
+        else if (s == symbol("tier"))
+            m_gc_strategy = GC_TIER;
         else 
             throw sat_param_exception("invalid gc strategy");
         m_gc_initial      = p.gc_initial();
         m_gc_increment    = p.gc_increment();
         m_gc_small_lbd    = p.gc_small_lbd();
+        m_gc_tier2_lbd    = p.gc_tier2_lbd();
         m_gc_k            = std::min(255u, p.gc_k());
         m_gc_burst        = p.gc_burst();
         m_gc_defrag       = p.gc_defrag();
 
+        m_learned_cache_file        = p.learned_cache_file();
+        m_learned_cache_max_size    = p.learned_cache_max_size();
+        m_learned_cache_max_glue    = p.learned_cache_max_glue();
+        m_learned_cache_max_clauses = p.learned_cache_max_clauses();
+
         m_force_cleanup   = p.force_cleanup();
 
         m_backtrack_scopes = p.backtrack_scopes();
@@ -194,6 +208,11 @@ namespace sat {
         m_minimize_lemmas = p.minimize_lemmas();
         m_core_minimize   = p.core_minimize();
         m_core_minimize_partial   = p.core_minimize_partial();
+        m_core_minimize_threads   = std::max(1u, p.core_minimize_threads());
+        m_core_minimize_budget    = p.core_minimize_budget();
+        m_assumptions_reuse = p.assumptions_reuse();
+        // global parameter, read once here instead of taking the gparams lock on every check
+        m_model_validate = gparams::get_ref().get_bool("model_validate", false);
         m_drat_check_unsat  = p.drat_check_unsat();
         m_drat_check_sat  = p.drat_check_sat();
         m_drat_file       = p.drat_file();
@@ -44,7 +44,8 @@ namespace sat {
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIER
     };
 
     enum branching_heuristic {
@@ -111,6 +112,9 @@ namespace sat {
         bool               m_enable_pre_simplify;
         unsigned           m_max_conflicts;
         unsigned           m_num_threads;
+        unsigned           m_par_share_glue;
+        unsigned           m_par_share_size;
+        unsigned           m_par_share_batch;
         bool               m_ddfw_search;
         unsigned           m_ddfw_threads;
         bool               m_prob_search;
@@ -119,6 +123,8 @@ namespace sat {
         local_search_mode  m_local_search_mode;
         bool               m_local_search_dbg_flips;
         bool               m_binspr;
+        bool               m_vivify;
+        unsigned           m_vivify_limit;
         bool               m_cut_simplify;
         unsigned           m_cut_delay;
         bool               m_cut_aig;
@@ -158,10 +164,17 @@ namespace sat {
         unsigned           m_gc_initial;
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
+        unsigned           m_gc_tier2_lbd;
         unsigned           m_gc_k;
         bool               m_gc_burst;
         bool               m_gc_defrag;
 
+        // learned clause cache
+        symbol             m_learned_cache_file;
+        unsigned           m_learned_cache_max_size;
+        unsigned           m_learned_cache_max_glue;
+        unsigned           m_learned_cache_max_clauses;
+
         bool               m_force_cleanup;
 
         // backtracking
@@ -171,7 +184,11 @@ namespace sat {
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
         bool               m_core_minimize;
+        bool               m_assumptions_reuse;
+        bool               m_model_validate;
         bool               m_core_minimize_partial;
+        unsigned           m_core_minimize_threads;
+        unsigned           m_core_minimize_budget;
 
         // drat proofs
         bool               m_drat;
@@ -27,14 +27,15 @@
 
 #include "util/luby.h"
 #include "sat/sat_ddfw.h"
+#include "sat/sat_ddfw_simd.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_params.hpp"
 
 namespace sat {
 
     ddfw::~ddfw() {
-        for (auto& ci : m_clauses) {
-            m_alloc.del_clause(ci.m_clause);
+        for (clause* c : m_clauses) {
+            m_alloc.del_clause(c);
         }
     }
 
@@ -85,34 +86,32 @@ namespace sat {
         return false;
     }
 
+    /**
+       \brief Select a variable with probability proportional to its positive reward,
+       otherwise a random variable with reward 0. The sums over the rewards use
+       simd::sum_pos and simd::select_pos, which rely on score(r) == r.
+    */
     bool_var ddfw::pick_var() {
-        double sum_pos = 0;
-        unsigned n = 1;
-        bool_var v0 = null_bool_var;
-        for (bool_var v : m_unsat_vars) {
-            int r = reward(v);
-            if (r > 0) {                
-                sum_pos += score(r);
-            }
-            else if (r == 0 && sum_pos == 0 && (m_rand() % (n++)) == 0) {
-                v0 = v;
-            }
-        }
+        unsigned const* vars = m_unsat_vars.begin();
+        unsigned sz = m_unsat_vars.size();
+        double sum_pos = static_cast<double>(simd::sum_pos(m_rewards.data(), vars, sz));
         if (sum_pos > 0) {
             double lim_pos = ((double) m_rand() / (1.0 + m_rand.max_value())) * sum_pos;                
-            for (bool_var v : m_unsat_vars) {
-                int r = reward(v);
-                if (r > 0) {
-                    lim_pos -= score(r);
-                    if (lim_pos <= 0) {
-                        if (m_par) update_reward_avg(v);
-                        return v;
-                    }
-                }
+            unsigned i = simd::select_pos(m_rewards.data(), vars, sz, lim_pos);
+            if (i < sz) {
+                bool_var v = vars[i];
+                if (m_par) update_reward_avg(v);
+                return v;
             }
         }
-        if (v0 != null_bool_var) {
-            return v0;
+        else {
+            unsigned n = 1;
+            bool_var v0 = null_bool_var;
+            for (bool_var v : m_unsat_vars) 
+                if (reward(v) == 0 && (m_rand() % (n++)) == 0) 
+                    v0 = v;
+            if (v0 != null_bool_var) 
+                return v0;
         }
         return m_unsat_vars.elem_at(m_rand(m_unsat_vars.size()));
     }
@@ -129,19 +128,26 @@ namespace sat {
     void ddfw::add(unsigned n, literal const* c) {        
         clause* cls = m_alloc.mk_clause(n, c, false);
         unsigned idx = m_clauses.size();
-        m_clauses.push_back(clause_info(cls, m_config.m_init_clause_weight));
+        m_clauses.push_back(cls);
+        m_weights.push_back(m_config.m_init_clause_weight);
+        m_trues.push_back(0);
+        m_num_trues.push_back(0);
         for (literal lit : *cls) {
             m_use_list.reserve(2*(lit.var()+1));
             m_vars.reserve(lit.var()+1);
+            m_rewards.reserve(lit.var()+1, 0);
             m_use_list[lit.index()].push_back(idx);
         }
     }
 
     void ddfw::add(solver const& s) {
-        for (auto& ci : m_clauses) {
-            m_alloc.del_clause(ci.m_clause);
+        for (clause* c : m_clauses) {
+            m_alloc.del_clause(c);
         }
         m_clauses.reset(); 
+        m_weights.reset();
+        m_trues.reset();
+        m_num_trues.reset();
         m_use_list.reset();
         m_num_non_binary_clauses = 0;
 
@@ -233,11 +239,10 @@ namespace sat {
         literal nlit = ~lit;
         SASSERT(is_true(lit));
         for (unsigned cls_idx : use_list(*this, lit)) {
-            clause_info& ci = m_clauses[cls_idx];
-            ci.del(lit);
-            unsigned w = ci.m_weight;
+            del_true(cls_idx, lit);
+            unsigned w = m_weights[cls_idx];
             // cls becomes false: flip any variable in clause to receive reward w
-            switch (ci.m_num_trues) {
+            switch (m_num_trues[cls_idx]) {
             case 0: {
                 m_unsat.insert(cls_idx);
                 clause const& c = get_clause(cls_idx);
@@ -249,18 +254,17 @@ namespace sat {
                 break;
                 }
             case 1:
-                dec_reward(to_literal(ci.m_trues), w);
+                dec_reward(to_literal(m_trues[cls_idx]), w);
                 break;
             default:
                 break;
             }
         }
         for (unsigned cls_idx : use_list(*this, nlit)) {
-            clause_info& ci = m_clauses[cls_idx];             
-            unsigned w = ci.m_weight;
+            unsigned w = m_weights[cls_idx];
             // the clause used to have a single true (pivot) literal, now it has two.
             // Then the previous pivot is no longer penalized for flipping.
-            switch (ci.m_num_trues) {
+            switch (m_num_trues[cls_idx]) {
             case 0: {
                 m_unsat.remove(cls_idx);   
                 clause const& c = get_clause(cls_idx);
@@ -272,12 +276,12 @@ namespace sat {
                 break;
             }
             case 1:
-                inc_reward(to_literal(ci.m_trues), w);
+                inc_reward(to_literal(m_trues[cls_idx]), w);
                 break;
             default:
                 break;
             }
-            ci.add(nlit);
+            add_true(cls_idx, nlit);
         }
         value(v) = !value(v);
     }
@@ -289,54 +293,41 @@ namespace sat {
     void ddfw::do_reinit_weights() {
         log();
 
-        if (m_reinit_count % 2 == 0) { 
-            for (auto& ci : m_clauses) {
-                ci.m_weight += 1;                
-            }
-        }
-        else {
-            for (auto& ci : m_clauses) {
-                if (ci.is_true()) {
-                    ci.m_weight = m_config.m_init_clause_weight;
-                }
-                else {
-                    ci.m_weight = m_config.m_init_clause_weight + 1;
-                }                
-            }
-        }
+        if (m_reinit_count % 2 == 0) 
+            simd::inc_all(m_weights.data(), m_weights.size());
+        else 
+            simd::reset_weights(m_weights.data(), m_num_trues.data(), m_weights.size(), m_config.m_init_clause_weight);
         init_clause_data();   
         ++m_reinit_count;
         m_reinit_next += m_reinit_count * m_config.m_reinit_base;
     }
 
     void ddfw::init_clause_data() {
-        for (unsigned v = 0; v < num_vars(); ++v) {
+        for (unsigned v = 0; v < num_vars(); ++v) 
             make_count(v) = 0;
-            reward(v) = 0;
-        }
+        m_rewards.fill(0);
         m_unsat_vars.reset();
         m_unsat.reset();
+        m_trues.fill(0);
+        m_num_trues.fill(0);
         unsigned sz = m_clauses.size();
         for (unsigned i = 0; i < sz; ++i) {
-            auto& ci = m_clauses[i];
             clause const& c = get_clause(i);
-            ci.m_trues = 0;
-            ci.m_num_trues = 0;
             for (literal lit : c) {
                 if (is_true(lit)) {
-                    ci.add(lit);
+                    add_true(i, lit);
                 }
             }
-            switch (ci.m_num_trues) {
+            switch (m_num_trues[i]) {
             case 0:
                 for (literal lit : c) {
-                    inc_reward(lit, ci.m_weight);
+                    inc_reward(lit, m_weights[i]);
                     inc_make(lit);
                 }
                 m_unsat.insert(i);
                 break;
             case 1:
-                dec_reward(to_literal(ci.m_trues), ci.m_weight);
+                dec_reward(to_literal(m_trues[i]), m_weights[i]);
                 break;
             default:
                 break;
@@ -450,11 +441,11 @@ namespace sat {
        3. select multiple clauses instead of just one per clause in unsat.
      */
 
-    bool ddfw::select_clause(unsigned max_weight, unsigned max_trues, clause_info const& cn, unsigned& n) {
-        if (cn.m_num_trues == 0 || cn.m_weight < max_weight) {
+    bool ddfw::select_clause(unsigned max_weight, unsigned max_trues, unsigned cn_idx, unsigned& n) {
+        if (m_num_trues[cn_idx] == 0 || m_weights[cn_idx] < max_weight) {
             return false;
         }
-        if (cn.m_weight > max_weight) {
+        if (m_weights[cn_idx] > max_weight) {
             n = 2;
             return true;
         } 
@@ -469,11 +460,10 @@ namespace sat {
         unsigned n = 1;
         for (literal lit : c) {
             for (unsigned cn_idx : use_list(*this, lit)) {
-                auto& cn = m_clauses[cn_idx];
-                if (select_clause(max_weight, max_trues, cn, n)) {
+                if (select_clause(max_weight, max_trues, cn_idx, n)) {
                     cl = cn_idx;
-                    max_weight = cn.m_weight;
-                    max_trues = cn.m_num_trues;
+                    max_weight = m_weights[cn_idx];
+                    max_trues = m_num_trues[cn_idx];
                 }
             }
         }
@@ -483,29 +473,26 @@ namespace sat {
     void ddfw::shift_weights() {
         ++m_shifts;
         for (unsigned cf_idx : m_unsat) {
-            auto& cf = m_clauses[cf_idx];
-            SASSERT(!cf.is_true());
+            SASSERT(!is_true(cf_idx));
             unsigned cn_idx = select_max_same_sign(cf_idx);
             while (cn_idx == UINT_MAX) {
                 unsigned idx = (m_rand() * m_rand()) % m_clauses.size();
-                auto & cn = m_clauses[idx];
-                if (cn.is_true() && cn.m_weight >= 2) {
+                if (is_true(idx) && m_weights[idx] >= 2) {
                     cn_idx = idx;
                 }
             }
-            auto & cn = m_clauses[cn_idx];
-            SASSERT(cn.is_true());
-            unsigned wn = cn.m_weight;
+            SASSERT(is_true(cn_idx));
+            unsigned wn = m_weights[cn_idx];
             SASSERT(wn >= 2);
             unsigned inc = (wn > 2) ? 2 : 1; 
             SASSERT(wn - inc >= 1);            
-            cf.m_weight += inc;
-            cn.m_weight -= inc;
+            m_weights[cf_idx] += inc;
+            m_weights[cn_idx] -= inc;
             for (literal lit : get_clause(cf_idx)) {
                 inc_reward(lit, inc);
             }
-            if (cn.m_num_trues == 1) {
-                inc_reward(to_literal(cn.m_trues), inc);
+            if (m_num_trues[cn_idx] == 1) {
+                inc_reward(to_literal(m_trues[cn_idx]), inc);
             }
         }
         // DEBUG_CODE(invariant(););
@@ -515,8 +502,7 @@ namespace sat {
         unsigned num_cls = m_clauses.size();
         for (unsigned i = 0; i < num_cls; ++i) {
             out << get_clause(i) << " ";
-            auto const& ci = m_clauses[i];
-            out << ci.m_num_trues << " " << ci.m_weight << "\n";
+            out << m_num_trues[i] << " " << m_weights[i] << "\n";
         }
         for (unsigned v = 0; v < num_vars(); ++v) {
             out << v << ": " << reward(v) << "\n";
@@ -546,24 +532,22 @@ namespace sat {
             int v_reward = 0;
             literal lit(v, !value(v));
             for (unsigned j : m_use_list[lit.index()]) {
-                clause_info const& ci = m_clauses[j];
-                if (ci.m_num_trues == 1) {
-                    SASSERT(lit == to_literal(ci.m_trues));
-                    v_reward -= ci.m_weight;
+                if (m_num_trues[j] == 1) {
+                    SASSERT(lit == to_literal(m_trues[j]));
+                    v_reward -= m_weights[j];
                 }
             }
             for (unsigned j : m_use_list[(~lit).index()]) {
-                clause_info const& ci = m_clauses[j];
-                if (ci.m_num_trues == 0) {
-                    v_reward += ci.m_weight;
+                if (m_num_trues[j] == 0) {
+                    v_reward += m_weights[j];
                 }                
             }
             IF_VERBOSE(0, if (v_reward != reward(v)) verbose_stream() << v << " " << v_reward << " " << reward(v) << "\n");
             SASSERT(reward(v) == v_reward);
         }
         DEBUG_CODE(
-            for (auto const& ci : m_clauses) {
-                SASSERT(ci.m_weight > 0);
+            for (unsigned w : m_weights) {
+                SASSERT(w > 0);
             }
             for (unsigned i = 0; i < m_clauses.size(); ++i) {
                 bool found = false;
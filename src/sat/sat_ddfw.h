@@ -33,17 +33,6 @@ namespace sat {
 
     class ddfw : public i_local_search {
 
-        struct clause_info {
-            clause_info(clause* cl, unsigned init_weight): m_weight(init_weight), m_trues(0), m_num_trues(0), m_clause(cl) {}
-            unsigned m_weight;       // weight of clause
-            unsigned m_trues;        // set of literals that are true
-            unsigned m_num_trues;    // size of true set
-            clause*  m_clause;
-            bool is_true() const { return m_num_trues > 0; }
-            void add(literal lit) { ++m_num_trues; m_trues += lit.index(); }
-            void del(literal lit) { SASSERT(m_num_trues > 0); --m_num_trues; m_trues -= lit.index(); }
-        };
-
         struct config {
             config() { reset(); }
             unsigned m_use_reward_zero_pct;
@@ -65,9 +54,8 @@ namespace sat {
         };
 
         struct var_info {
-            var_info(): m_value(false), m_reward(0), m_make_count(0), m_bias(0), m_reward_avg(1e-5) {}
+            var_info(): m_value(false), m_make_count(0), m_bias(0), m_reward_avg(1e-5) {}
             bool     m_value;
-            int      m_reward;
             unsigned m_make_count;
             int      m_bias;
             ema      m_reward_avg;
@@ -76,9 +64,15 @@ namespace sat {
         config           m_config;
         reslimit         m_limit;
         clause_allocator m_alloc;
-        svector<clause_info> m_clauses;
+        // clauses are stored as a structure of arrays indexed by the clause index, 
+        // such that flips and weight updates only touch the fields they use.
+        ptr_vector<clause>   m_clauses;
+        unsigned_vector      m_weights;     // clause -> weight
+        unsigned_vector      m_trues;       // clause -> sum of the indices of its true literals
+        unsigned_vector      m_num_trues;   // clause -> number of true literals
         literal_vector       m_assumptions;        
         svector<var_info>    m_vars;        // var -> info
+        svector<int>         m_rewards;     // var -> reward
         svector<double>      m_probs;       // var -> probability of flipping
         svector<double>      m_scores;      // reward -> score
         model                m_model;       // var -> best assignment
@@ -124,9 +118,9 @@ namespace sat {
 
         inline bool value(bool_var v) const { return m_vars[v].m_value; }
 
-        inline int& reward(bool_var v) { return m_vars[v].m_reward; }
+        inline int& reward(bool_var v) { return m_rewards[v]; }
 
-        inline int reward(bool_var v) const { return m_vars[v].m_reward; }
+        inline int reward(bool_var v) const { return m_rewards[v]; }
 
         inline int& bias(bool_var v) { return m_vars[v].m_bias; }
 
@@ -134,11 +128,15 @@ namespace sat {
 
         inline bool is_true(literal lit) const { return value(lit.var()) != lit.sign(); }
 
-        inline clause const& get_clause(unsigned idx) const { return *m_clauses[idx].m_clause; }
+        inline clause const& get_clause(unsigned idx) const { return *m_clauses[idx]; }
+
+        inline unsigned get_weight(unsigned idx) const { return m_weights[idx]; }
+
+        inline bool is_true(unsigned idx) const { return m_num_trues[idx] > 0; }
 
-        inline unsigned get_weight(unsigned idx) const { return m_clauses[idx].m_weight; }
+        inline void add_true(unsigned idx, literal lit) { ++m_num_trues[idx]; m_trues[idx] += lit.index(); }
 
-        inline bool is_true(unsigned idx) const { return m_clauses[idx].is_true(); }
+        inline void del_true(unsigned idx, literal lit) { SASSERT(m_num_trues[idx] > 0); --m_num_trues[idx]; m_trues[idx] -= lit.index(); }
 
         void update_reward_avg(bool_var v) { m_vars[v].m_reward_avg.update(reward(v)); }
 
@@ -170,7 +168,7 @@ namespace sat {
         // reinitialize weights activity
         bool should_reinit_weights();        
         void do_reinit_weights();
-        inline bool select_clause(unsigned max_weight, unsigned max_trues, clause_info const& cn, unsigned& n);
+        inline bool select_clause(unsigned max_weight, unsigned max_trues, unsigned cn_idx, unsigned& n);
 
         // restart activity
         bool should_restart();
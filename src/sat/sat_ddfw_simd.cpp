@@ -0,0 +1,156 @@
+/*++
+Copyright (c) 2019 Microsoft Corporation
+
+Module Name:
+
+    sat_ddfw_simd.cpp
+
+Abstract:
+
+    Bulk operations over the clause and variable arrays of ddfw.
+
+--*/
+
+#include "sat/sat_ddfw_simd.h"
+
+#ifdef Z3_DDFW_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__AVX2__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX2_DISPATCH
+#else
+#define AVX2_TARGET
+#endif
+#endif
+
+namespace sat {
+
+    namespace simd {
+
+        namespace scalar {
+
+            void inc_all(unsigned* w, unsigned n) {
+                for (unsigned i = 0; i < n; ++i)
+                    w[i] += 1;
+            }
+
+            void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init) {
+                for (unsigned i = 0; i < n; ++i)
+                    w[i] = num_trues[i] == 0 ? init + 1 : init;
+            }
+
+            int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n) {
+                int64_t sum = 0;
+                for (unsigned i = 0; i < n; ++i)
+                    if (rewards[vars[i]] > 0)
+                        sum += rewards[vars[i]];
+                return sum;
+            }
+        }
+
+#ifdef Z3_DDFW_AVX2
+        namespace avx2 {
+
+            AVX2_TARGET void inc_all(unsigned* w, unsigned n) {
+                unsigned i = 0;
+                __m256i one = _mm256_set1_epi32(1);
+                for (; i + 8 <= n; i += 8) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(w + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(w + i), _mm256_add_epi32(x, one));
+                }
+                scalar::inc_all(w + i, n - i);
+            }
+
+            AVX2_TARGET void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init) {
+                unsigned i = 0;
+                __m256i base = _mm256_set1_epi32(init), zero = _mm256_setzero_si256();
+                for (; i + 8 <= n; i += 8) {
+                    __m256i t = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(num_trues + i));
+                    // the mask is -1 for false clauses
+                    __m256i is_false = _mm256_cmpeq_epi32(t, zero);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(w + i), _mm256_sub_epi32(base, is_false));
+                }
+                scalar::reset_weights(w + i, num_trues + i, n - i, init);
+            }
+
+            AVX2_TARGET int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n) {
+                unsigned i = 0;
+                __m256i zero = _mm256_setzero_si256(), acc = _mm256_setzero_si256();
+                for (; i + 8 <= n; i += 8) {
+                    __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(vars + i));
+                    __m256i r = _mm256_max_epi32(_mm256_i32gather_epi32(rewards, idx, 4), zero);
+                    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(r)));
+                    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(r, 1)));
+                }
+                int64_t lanes[4];
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+                return lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar::sum_pos(rewards, vars + i, n - i);
+            }
+        }
+#endif
+
+        static bool detect_avx2() {
+#if defined(AVX2_DISPATCH)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(Z3_DDFW_AVX2)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        static const bool g_has_avx2 = detect_avx2();
+
+        bool has_avx2() {
+            return g_has_avx2;
+        }
+
+        void inc_all(unsigned* w, unsigned n) {
+#ifdef Z3_DDFW_AVX2
+            if (g_has_avx2) {
+                avx2::inc_all(w, n);
+                return;
+            }
+#endif
+            scalar::inc_all(w, n);
+        }
+
+        void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init) {
+#ifdef Z3_DDFW_AVX2
+            if (g_has_avx2) {
+                avx2::reset_weights(w, num_trues, n, init);
+                return;
+            }
+#endif
+            scalar::reset_weights(w, num_trues, n, init);
+        }
+
+        int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n) {
+#ifdef Z3_DDFW_AVX2
+            if (g_has_avx2)
+                return avx2::sum_pos(rewards, vars, n);
+#endif
+            return scalar::sum_pos(rewards, vars, n);
+        }
+
+        unsigned select_pos(int const* rewards, unsigned const* vars, unsigned n, double lim) {
+            unsigned i = 0;
+            for (; i + block_size <= n; i += block_size) {
+                double block_sum = static_cast<double>(sum_pos(rewards, vars + i, block_size));
+                if (lim - block_sum <= 0)
+                    break;
+                lim -= block_sum;
+            }
+            for (; i < n; ++i) {
+                int r = rewards[vars[i]];
+                if (r > 0) {
+                    lim -= r;
+                    if (lim <= 0)
+                        return i;
+                }
+            }
+            return n;
+        }
+    }
+}
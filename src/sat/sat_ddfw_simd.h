@@ -0,0 +1,67 @@
+/*++
+Copyright (c) 2019 Microsoft Corporation
+
+Module Name:
+
+    sat_ddfw_simd.h
+
+Abstract:
+
+    Bulk operations over the clause and variable arrays of ddfw.
+
+    On x86-64 with GCC or Clang the AVX2 kernels are compiled with
+    target("avx2") and selected at run time when the CPU supports AVX2.
+    Other compilers use them when the target enables AVX2 (e.g., /arch:AVX2).
+    Otherwise the scalar kernels are used.
+
+--*/
+#pragma once
+
+#include <cstdint>
+
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || defined(__AVX2__)
+#define Z3_DDFW_AVX2
+#endif
+
+namespace sat {
+
+    namespace simd {
+
+        static const unsigned block_size = 64;
+
+        // w[i] := w[i] + 1
+        void inc_all(unsigned* w, unsigned n);
+
+        // w[i] := init if clause i is satisfied, init + 1 otherwise.
+        void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init);
+
+        // sum of the positive rewards of vars[0], .., vars[n-1].
+        int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n);
+
+        /**
+           \brief Index of the first variable where the running sum of the positive
+           rewards reaches lim, or n if the sum of all positive rewards is below lim.
+           Blocks of block_size variables whose sum is below the remaining limit
+           are skipped using sum_pos.
+        */
+        unsigned select_pos(int const* rewards, unsigned const* vars, unsigned n, double lim);
+
+        // true if the AVX2 kernels are used.
+        bool has_avx2();
+
+        namespace scalar {
+            void inc_all(unsigned* w, unsigned n);
+            void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init);
+            int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n);
+        }
+
+#ifdef Z3_DDFW_AVX2
+        // require has_avx2().
+        namespace avx2 {
+            void inc_all(unsigned* w, unsigned n);
+            void reset_weights(unsigned* w, unsigned const* num_trues, unsigned n, unsigned init);
+            int64_t sum_pos(int const* rewards, unsigned const* vars, unsigned n);
+        }
+#endif
+    }
+}
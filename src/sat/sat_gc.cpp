@@ -55,6 +55,9 @@ namespace sat {
         case GC_PSM_GLUE:
             gc_psm_glue();
             break;
+        case GC_TIER:
+            gc_tier();
+            break;
         case GC_DYN_PSM:
             if (!m_assumptions.empty()) {
                 gc_glue_psm();
@@ -144,6 +147,71 @@ namespace sat {
         gc_half("psm-glue");
     }
 
+    /**
+       \brief Lex on (used, glue, size) for clauses of the local tier.
+    */
+    struct used_glue_lt {
+        bool operator()(clause const * c1, clause const * c2) const {
+            if (c1->was_used() != c2->was_used()) return c1->was_used();
+            if (c1->glue() < c2->glue()) return true;
+            return c1->glue() == c2->glue() && c1->size() < c2->size();
+        }
+    };
+
+    /**
+       \brief Tiered gc of learned clauses.
+       Core clauses (glue <= gc.small_lbd) are never deleted.
+       Tier-2 clauses (glue <= gc.tier2_lbd) are kept while they are used; 
+       after gc.k rounds without use they are demoted to the local tier.
+       The local tier is sorted by activity and its second half is deleted.
+       Clauses move between tiers as their glue is updated during propagation.
+    */
+    void solver::gc_tier() {
+        TRACE("sat", tout << "gc\n";);
+        unsigned core = 0, tier2 = 0;
+        clause_vector local;
+        unsigned j = 0;
+        for (clause* cp : m_learned) {
+            clause & c = *cp;
+            if (c.glue() <= m_config.m_gc_small_lbd) {
+                c.reset_inact_rounds();
+                core++;
+            }
+            else if (c.glue() <= m_config.m_gc_tier2_lbd && c.was_used()) {
+                c.reset_inact_rounds();
+                tier2++;
+            }
+            else if (c.glue() <= m_config.m_gc_tier2_lbd && c.inact_rounds() < m_config.m_gc_k) {
+                c.inc_inact_rounds();
+                tier2++;
+            }
+            else {
+                local.push_back(cp);
+                continue;
+            }
+            c.unmark_used();
+            m_learned[j++] = cp;
+        }
+        std::stable_sort(local.begin(), local.end(), used_glue_lt());
+        unsigned keep = local.size() / 2;
+        unsigned deleted = 0;
+        for (unsigned i = 0; i < local.size(); i++) {
+            clause & c = *local[i];
+            if (i >= keep && can_delete(c)) {
+                detach_clause(c);
+                del_clause(c);
+                deleted++;
+                continue;
+            }
+            c.unmark_used();
+            m_learned[j++] = &c;
+        }
+        m_learned.shrink(j);
+        m_stats.m_gc_clause += deleted;
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tier :core " << core << " :tier2 " << tier2 
+                   << " :local " << local.size() << " :deleted " << deleted << ")\n";);
+    }
+
     /**
        \brief Compute the psm of all learned clauses.
     */
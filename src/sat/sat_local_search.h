@@ -112,10 +112,9 @@ namespace sat {
         struct constraint {
             unsigned        m_id;
             unsigned        m_k;
-            int64_t         m_slack;
             unsigned        m_size;
             literal_vector  m_literals;
-            constraint(unsigned k, unsigned id) : m_id(id), m_k(k), m_slack(0), m_size(0) {}
+            constraint(unsigned k, unsigned id) : m_id(id), m_k(k), m_size(0) {}
             void push(literal l) { m_literals.push_back(l); ++m_size; }
             unsigned size() const { return m_size; }
             literal const& operator[](unsigned idx) const { return m_literals[idx]; }
@@ -131,6 +130,7 @@ namespace sat {
         bool_vector       m_best_phase;                // best value in round
         svector<bool_var>   m_units;                     // unit clauses
         vector<constraint>  m_constraints;               // all constraints
+        svector<int64_t>    m_slacks;                    // constraint -> slack, kept apart from the constraints for dense access during flips
         literal_vector      m_assumptions;               // temporary assumptions
         literal_vector      m_prop_queue;                // propagation queue
         unsigned            m_num_non_binary_clauses;       
@@ -187,7 +187,7 @@ namespace sat {
 
         unsigned num_constraints() const { return m_constraints.size(); } // constraint index from 1 to num_constraint
 
-        int64_t constraint_slack(unsigned ci) const { return m_constraints[ci].m_slack; }
+        int64_t constraint_slack(unsigned ci) const { return m_slacks[ci]; }
 
         void init();
         void reinit();
@@ -18,6 +18,8 @@ Notes:
 
 --*/
 
+#include "util/scoped_timer.h"
+#include "util/thread_pool.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_mus.h"
 
@@ -51,6 +53,8 @@ namespace sat {
         flet<bool> _disable_min(s.m_config.m_core_minimize, false);
         flet<bool> _is_active(m_is_active, true);
         IF_VERBOSE(3, verbose_stream() << "(sat.mus size: " << s.get_core().size() << " core: [" << s.get_core() << "])\n";);
+        m_stopwatch.reset();
+        m_stopwatch.start();
         reset();
         lbool r = mus1();
         return r;
@@ -61,6 +65,9 @@ namespace sat {
         TRACE("sat", tout << "old core: " << s.get_core() << "\n";);
         literal_vector& core = get_core();
         literal_vector& mus = m_mus;
+        if (!minimize_partial && s.m_config.m_core_minimize_threads > 1 && !s.m_ext && core.size() > 2) {
+            return mus_par();
+        }
         if (!minimize_partial && core.size() > 64) {
             return mus2();
         }
@@ -72,7 +79,7 @@ namespace sat {
                   tout << "core: " << core << "\n";
                   tout << "mus:  " << mus  << "\n";);
 
-            if (s.canceled()) {
+            if (s.canceled() || budget_exceeded()) {
                 set_core();
                 return l_undef;
             }
@@ -135,6 +142,180 @@ namespace sat {
     }
     
 
+    bool mus::budget_exceeded() {
+        unsigned budget = s.m_config.m_core_minimize_budget;
+        return budget > 0 && m_stopwatch.get_current_seconds() * 1000 >= budget;
+    }
+
+    /**
+       \brief Cancel the worker solvers when the time budget for core minimization is used up.
+    */
+    class mus_budget_eh : public event_handler {
+        vector<reslimit>& m_limits;
+    public:
+        mus_budget_eh(vector<reslimit>& limits): m_limits(limits) {}
+        void operator()(event_handler_caller_t caller_id) override {
+            m_caller_id = caller_id;
+            for (reslimit& lim : m_limits)
+                lim.cancel();
+        }
+    };
+
+    /**
+       \brief Core minimization using copies of the solver that test deletions in parallel.
+
+       Each round assigns a group of candidate literals to every worker, which checks the
+       core without its group. Literals whose deletion is satisfiable are necessary in every
+       sub-core, so all of them are added to the mus. Of the unsatisfiable deletions, the one
+       leaving the fewest candidates is applied. Groups start large and are halved when a
+       round removes no candidates, in the style of QuickXplain, so that large cores shrink
+       without testing their literals one at a time.
+    */
+    lbool mus::mus_par() {
+        literal_vector& core = m_core;
+        literal_vector& mus = m_mus;
+        unsigned num_workers = s.m_config.m_core_minimize_threads;
+        vector<reslimit> limits(num_workers);
+        scoped_limits scoped_rlimit(s.rlimit());
+        // s still holds the conflict of the check that produced the core, a copy of an
+        // inconsistent solver would be empty.
+        s.pop_to_base_level();
+        if (s.inconsistent()) {
+            set_core();
+            return l_undef;
+        }
+        scoped_ptr_vector<solver> workers;
+        for (unsigned i = 0; i < num_workers; ++i) {
+            solver* w = alloc(solver, s.m_params, limits[i]);
+            w->copy(s, true);
+            w->m_config.m_core_minimize = false;
+            w->m_config.m_num_threads = 1;
+            w->m_config.m_local_search_threads = 0;
+            w->m_config.m_ddfw_threads = 0;
+            w->m_config.m_local_search = false;
+            w->m_config.m_ddfw_search = false;
+            w->m_config.m_prob_search = false;
+            workers.push_back(w);
+            scoped_rlimit.push_child(&limits[i]);
+        }
+        mus_budget_eh eh(limits);
+        scoped_ptr<scoped_timer> timer;
+        if (s.m_config.m_core_minimize_budget > 0) {
+            double spent = m_stopwatch.get_current_seconds() * 1000;
+            unsigned budget = s.m_config.m_core_minimize_budget;
+            timer = alloc(scoped_timer, spent < budget ? budget - static_cast<unsigned>(spent) : 1, &eh);
+        }
+
+        vector<literal_vector> cores(num_workers);
+        svector<lbool> results(num_workers, l_undef);
+        literal_vector necessary, reduced;
+        literal_set core_set;
+        unsigned group_size = std::max(1u, core.size() / (2 * num_workers));
+        // group i contains the literals core[group_begin(i)] .. core[group_end(i) - 1] counted from the back.
+        auto group_end = [&](unsigned i) { return core.size() - i * group_size; };
+        auto group_begin = [&](unsigned i) { return core.size() > (i + 1) * group_size ? core.size() - (i + 1) * group_size : 0; };
+
+        while (!core.empty()) {
+            if (s.canceled() || budget_exceeded()) {
+                set_core();
+                return l_undef;
+            }
+            if (core.size() + mus.size() <= 2) 
+                break;
+            group_size = std::min(group_size, std::max(1u, core.size() / num_workers));
+            unsigned num_groups = std::min(num_workers, (core.size() + group_size - 1) / group_size);
+            IF_VERBOSE(1, verbose_stream() << "(sat.mus num-to-process: " << core.size() << " mus: " << mus.size() 
+                       << " groups: " << num_groups << " group-size: " << group_size << ")\n";);
+
+            // tasks skipped after a cancellation keep the result l_undef.
+            results.fill(l_undef);
+            thread_pool::run(num_groups, [&](unsigned i) {
+                unsigned b = group_begin(i), e = group_end(i);
+                literal_vector asms;
+                for (literal lit : s.m_user_scope_literals)
+                    asms.push_back(~lit);
+                asms.append(mus);
+                for (unsigned j = 0; j < core.size(); ++j)
+                    if (j < b || j >= e)
+                        asms.push_back(core[j]);
+                if (e - b == 1)
+                    asms.push_back(~core[b]);
+                results[i] = workers[i]->check(asms.size(), asms.data());
+                cores[i].reset();
+                if (results[i] == l_false)
+                    cores[i].append(workers[i]->get_core());
+            }, &s.rlimit());
+
+            // collect the necessary literals and pick the deletion that leaves the fewest candidates.
+            necessary.reset();
+            core_set.reset();
+            for (literal lit : core)
+                core_set.insert(lit);
+            unsigned best = UINT_MAX, best_size = UINT_MAX;
+            bool split = false, aborted = false;
+            for (unsigned i = 0; i < num_groups; ++i) {
+                unsigned b = group_begin(i), e = group_end(i);
+                switch (results[i]) {
+                case l_true:
+                    if (m_model.empty())
+                        m_model.append(workers[i]->get_model());
+                    if (e - b == 1)
+                        necessary.push_back(core[b]);
+                    else
+                        split = true;
+                    break;
+                case l_undef:
+                    // the worker was canceled or ran out of budget, nothing is known about the group.
+                    aborted = true;
+                    break;
+                case l_false: {
+                    unsigned sz = 0;
+                    if (e - b == 1 && cores[i].contains(~core[b]))
+                        sz = core.size() - 1;
+                    else 
+                        for (literal lit : cores[i])
+                            sz += core_set.contains(lit);
+                    if (sz < best_size)
+                        best = i, best_size = sz;
+                    break;
+                }
+                }
+            }
+            if (aborted || s.canceled() || budget_exceeded()) {
+                set_core();
+                return l_undef;
+            }
+
+            if (best != UINT_MAX) {
+                unsigned b = group_begin(best), e = group_end(best);
+                reduced.reset();
+                if (e - b == 1 && cores[best].contains(~core[b])) {
+                    IF_VERBOSE(3, verbose_stream() << "(sat.mus unit reduction, literal is in both cores " << core[b] << ")\n";);
+                    for (unsigned j = 0; j < core.size(); ++j)
+                        if (j != b)
+                            reduced.push_back(core[j]);
+                }
+                else {
+                    for (literal lit : cores[best])
+                        if (core_set.contains(lit))
+                            reduced.push_back(lit);
+                }
+                core.reset();
+                core.append(reduced);
+            }
+            else if (split && group_size > 1) {
+                group_size /= 2;
+            }
+            for (literal lit : necessary) {
+                core.erase(lit);
+                mus.push_back(lit);
+            }
+        }
+        set_core();
+        IF_VERBOSE(3, verbose_stream() << "(sat.mus.new " << s.m_core << ")\n";);
+        return l_true;
+    }
+
     // bisection search.
     lbool mus::mus2() {
         literal_set core(get_core());
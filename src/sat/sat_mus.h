@@ -26,6 +26,7 @@ namespace sat {
         bool           m_is_active;
         model          m_model;       // model obtained during minimal unsat core
         unsigned       m_max_num_restarts;
+        stopwatch      m_stopwatch;
 
 
     public:
@@ -37,6 +38,8 @@ namespace sat {
     private:
         lbool mus1();
         lbool mus2();
+        lbool mus_par();
+        bool budget_exceeded();
         lbool qx(literal_set& assignment, literal_set& support, bool has_support);
         void reset();
         void set_core();
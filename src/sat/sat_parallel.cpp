@@ -22,75 +22,75 @@ Revision History:
 
 namespace sat {
 
-    void parallel::vector_pool::next(unsigned& index) {
-        SASSERT(index < m_size);
-        unsigned n = index + 2 + get_length(index);
-        if (n >= m_size) {
-            index = 0;
-        }
-        else {
-            index = n;
-        }
-    }
-
-    void parallel::vector_pool::reserve(unsigned num_threads, unsigned sz) {
-        m_vectors.reset();
-        m_vectors.resize(sz, 0);
-        m_heads.reset();
-        m_heads.resize(num_threads, 0);
-        m_at_end.reset();
-        m_at_end.resize(num_threads, true);
-        m_tail = 0;
-        m_size = sz;
-    }
-    
-    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
-        SASSERT(m_tail < m_size);
-        unsigned capacity = n + 2;
-        m_vectors.reserve(m_size + capacity, 0);
-        IF_VERBOSE(3, verbose_stream() << owner << ": begin-add " << n << " tail: " << m_tail << " size: " << m_size << "\n";);
-        for (unsigned i = 0; i < m_heads.size(); ++i) {
-            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
-                next(m_heads[i]);
-            }
-            m_at_end[i] = false;
-        }
-        m_vectors[m_tail++] = owner;
-        m_vectors[m_tail++] = n;    
+    parallel::clause_ring::clause_ring(unsigned sz): m_capacity(std::max(sz, 2u)) {
+        m_slots = alloc_vect<std::atomic<unsigned>>(m_capacity);
+        for (unsigned i = 0; i < m_capacity; ++i) 
+            m_slots[i].store(0, std::memory_order_relaxed);
     }
 
-    void parallel::vector_pool::add_vector_elem(unsigned e) {
-        m_vectors[m_tail++] = e;
+    parallel::clause_ring::~clause_ring() {
+        dealloc_vect(m_slots, m_capacity);
     }
 
-    void parallel::vector_pool::end_add_vector() {
-        if (m_tail >= m_size) {
-            m_tail = 0;
-        }
+    /**
+       \brief Append an entry. Only called by the owner of the ring.
+       The extent of the region being written is announced before the entry is written
+       so that readers can detect entries that were overwritten while they read them.
+    */
+    bool parallel::clause_ring::push(unsigned n, unsigned const* elems) {
+        if (n + 1 > m_capacity)
+            return false;
+        uint64_t end = m_end + n + 1;
+        m_writing.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot(m_end).store(n, std::memory_order_relaxed);
+        for (unsigned i = 0; i < n; ++i)
+            slot(m_end + 1 + i).store(elems[i], std::memory_order_relaxed);
+        m_end = end;
+        return true;
     }
 
-
-    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
-        unsigned head = m_heads[owner];      
-        unsigned iterations = 0;
-        while (head != m_tail || !m_at_end[owner]) {
-            ++iterations;
-            SASSERT(head < m_size && m_tail < m_size);            
-            bool is_self = owner == get_owner(head);
-            next(m_heads[owner]);
-            IF_VERBOSE(static_cast<unsigned>(iterations > m_size ? 0 : 3), verbose_stream() << owner << ": [" << head << ":" << m_heads[owner] << "] tail: " << m_tail << "\n";);
-            m_at_end[owner] = (m_heads[owner] == m_tail);
-            if (!is_self) {
-                n = get_length(head);
-                ptr = get_ptr(head);
-                return true;
+    /**
+       \brief Retrieve the next published entry after position head.
+       Entries that were overwritten before the reader got to them are skipped.
+    */
+    bool parallel::clause_ring::get(uint64_t& head, unsigned_vector& elems) {
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        while (head < tail) {
+            elems.reset();
+            bool valid = head + m_capacity >= tail;
+            if (valid) {
+                unsigned n = slot(head).load(std::memory_order_relaxed);
+                valid = n + 1 <= m_capacity && head + n + 1 <= tail;
+                for (unsigned i = 0; valid && i < n; ++i) 
+                    elems.push_back(slot(head + 1 + i).load(std::memory_order_relaxed));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                valid &= m_writing.load(std::memory_order_relaxed) <= head + m_capacity;
+                if (valid) {
+                    head += n + 1;
+                    return true;
+                }
             }
-            head = m_heads[owner];
+            // the reader fell behind by more than the capacity of the ring.
+            head = tail;
+            tail = m_tail.load(std::memory_order_acquire);
         }
         return false;
     }
 
-    parallel::parallel(solver& s): m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
+    void parallel::reserve(unsigned num_owners, unsigned sz) {
+        m_clauses.reset();
+        for (unsigned i = 0; i < num_owners; ++i) 
+            m_clauses.push_back(alloc(clause_ring, sz));
+        m_heads.reset();
+        m_heads.resize(num_owners * num_owners, 0);
+    }
+
+    parallel::parallel(solver& s): 
+        m_share_glue(s.get_config().m_par_share_glue),
+        m_share_size(s.get_config().m_par_share_size),
+        m_share_batch(s.get_config().m_par_share_batch),
+        m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
 
     parallel::~parallel() {
         for (unsigned i = 0; i < m_solvers.size(); ++i) {            
@@ -126,80 +126,79 @@ namespace sat {
     void parallel::exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out) {
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        {
-            lock_guard lock(m_mux);
-            if (limit < m_units.size()) {
-                // this might repeat some literals.
-                out.append(m_units.size() - limit, m_units.data() + limit);
-            }
-            for (unsigned i = 0; i < in.size(); ++i) {
-                literal lit = in[i];
-                if (!m_unit_set.contains(lit.index())) {
-                    m_unit_set.insert(lit.index());
-                    m_units.push_back(lit);
-                }
+        lock_guard lock(m_mux);
+        if (limit < m_units.size()) {
+            // this might repeat some literals.
+            out.append(m_units.size() - limit, m_units.data() + limit);
+        }
+        for (literal lit : in) {
+            if (!m_unit_set.contains(lit.index())) {
+                m_unit_set.insert(lit.index());
+                m_units.push_back(lit);
             }
-            limit = m_units.size();
         }
+        limit = m_units.size();
+    }
+
+    /**
+       \brief Add an entry to the clause ring of s. Entries are published in batches,
+       the remaining entries are published when s retrieves clauses.
+    */
+    void parallel::share(solver& s, scoped_ptr_vector<clause_ring>& rings, unsigned n, unsigned const* elems) {
+        clause_ring& ring = *rings[s.m_par_id];
+        ring.push(n, elems);
+        if (ring.num_pending() >= m_share_batch)
+            ring.publish();
     }
 
     void parallel::share_clause(solver& s, literal l1, literal l2) {        
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
         IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  l1 << " " << l2 << "\n";);
-        {
-            lock_guard lock(m_mux);
-            m_pool.begin_add_vector(s.m_par_id, 2);
-            m_pool.add_vector_elem(l1.index());
-            m_pool.add_vector_elem(l2.index());            
-            m_pool.end_add_vector();
-        }        
+        unsigned elems[2] = { l1.index(), l2.index() };
+        share(s, m_clauses, 2, elems);
     }
 
     void parallel::share_clause(solver& s, clause const& c) {        
         if (s.get_config().m_num_threads == 1 || !enable_add(c) || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        unsigned n = c.size();
-        unsigned owner = s.m_par_id;
-        IF_VERBOSE(3, verbose_stream() << owner << ": share " <<  c << "\n";);
-        lock_guard lock(m_mux);
-        m_pool.begin_add_vector(owner, n);                
-        for (unsigned i = 0; i < n; ++i) {
-            m_pool.add_vector_elem(c[i].index());
-        }
-        m_pool.end_add_vector();        
+        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  c << "\n";);
+        sbuffer<unsigned> elems;
+        for (literal lit : c)
+            elems.push_back(lit.index());
+        share(s, m_clauses, elems.size(), elems.data());
     }
 
     void parallel::get_clauses(solver& s) {
         if (s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        lock_guard lock(m_mux);
-        _get_clauses(s);        
-    }
-
-    void parallel::_get_clauses(solver& s) {
-        unsigned n;
-        unsigned const* ptr;
         unsigned owner = s.m_par_id;
-        while (m_pool.get_vector(owner, n, ptr)) {
-            m_lits.reset();
-            bool usable_clause = true;
-            for (unsigned i = 0; usable_clause && i < n; ++i) {
-                literal lit(to_literal(ptr[i]));                
-                m_lits.push_back(lit);
-                usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
-            }
-            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << m_lits << "\n";);
-            SASSERT(n >= 2);
-            if (usable_clause) {
-                s.mk_clause_core(m_lits.size(), m_lits.data(), sat::status::redundant());
+        m_clauses[owner]->publish();
+        unsigned_vector elems;
+        literal_vector lits;
+        for (unsigned p = 0; p < m_clauses.size(); ++p) {
+            if (p == owner)
+                continue;
+            while (m_clauses[p]->get(head(owner, p), elems)) {
+                lits.reset();
+                bool usable_clause = true;
+                for (unsigned i = 0; usable_clause && i < elems.size(); ++i) {
+                    literal lit(to_literal(elems[i]));
+                    lits.push_back(lit);
+                    usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
+                }
+                IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << lits << "\n";);
+                SASSERT(elems.size() >= 2);
+                if (usable_clause) {
+                    s.mk_clause_core(lits.size(), lits.data(), sat::status::redundant());
+                }
             }
-        }        
+        }
     }
 
     bool parallel::enable_add(clause const& c) const {
         // plingeling, glucose heuristic:
-        return (c.size() <= 40 && c.glue() <= 8) || c.glue() <= 2;
+        return (c.size() <= m_share_size && c.glue() <= m_share_glue) || c.glue() <= 2;
     }
 
     void parallel::_from_solver(solver& s) {
@@ -24,43 +24,53 @@ Revision History:
 #include "util/rlimit.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/mutex.h"
+#include <atomic>
 
 namespace sat {
 
     class parallel {
 
-        // shared pool of learned clauses.
-        class vector_pool {
-            unsigned_vector m_vectors;
-            unsigned        m_size{ 0 };
-            unsigned        m_tail{ 0 };
-            unsigned_vector m_heads;
-            bool_vector   m_at_end;
-            void next(unsigned& index);
-            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
-            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
-            unsigned const* get_ptr(unsigned index) const { return m_vectors.data() + index + 2; }
+        // shared ring of clauses written by a single owner and read by all
+        // other threads. An entry consists of the number of literals followed by the
+        // literal indices. Readers keep their own position in the ring and validate
+        // after reading an entry that the owner has not overwritten it meanwhile.
+        // Entries become visible to readers when the owner publishes its pending entries.
+        class clause_ring {
+            std::atomic<unsigned>* m_slots { nullptr };
+            unsigned               m_capacity { 0 };
+            std::atomic<uint64_t>  m_writing { 0 };  // end of the region written by the owner
+            std::atomic<uint64_t>  m_tail { 0 };     // end of the published entries
+            uint64_t               m_end { 0 };      // end of the written entries, owner only
+            std::atomic<unsigned>& slot(uint64_t i) { return m_slots[i % m_capacity]; }
         public:
-            void reserve(unsigned num_owners, unsigned sz);
-            void begin_add_vector(unsigned owner, unsigned n);
-            void end_add_vector();
-            void add_vector_elem(unsigned e);
-            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+            clause_ring(unsigned sz);
+            ~clause_ring();
+            bool push(unsigned n, unsigned const* elems);
+            void publish() { m_tail.store(m_end, std::memory_order_release); }
+            unsigned num_pending() const { return static_cast<unsigned>(m_end - m_tail.load(std::memory_order_relaxed)); }
+            bool get(uint64_t& head, unsigned_vector& elems);
         };
 
         bool enable_add(clause const& c) const;
-        void _get_clauses(solver& s);
+        void share(solver& s, scoped_ptr_vector<clause_ring>& rings, unsigned n, unsigned const* elems);
+        uint64_t& head(unsigned owner, unsigned producer) { return m_heads[owner * m_clauses.size() + producer]; }
         void _from_solver(solver& s);
         bool _to_solver(solver& s);
         bool _from_solver(i_local_search& s);
         void _to_solver(i_local_search& s);
 
         typedef hashtable<unsigned, u_hash, u_eq> index_set;
-        literal_vector m_units;
-        index_set      m_unit_set;
-        literal_vector m_lits;
-        vector_pool    m_pool;
-        mutex          m_mux;
+
+        scoped_ptr_vector<clause_ring> m_clauses;
+        svector<uint64_t>  m_heads;       // read positions of each thread in the clause rings
+        // units are never dropped: they are kept in an unbounded list guarded by m_mux.
+        // units are rare compared to clauses, so the lock is not contended.
+        literal_vector     m_units;
+        index_set          m_unit_set;
+        unsigned           m_share_glue;
+        unsigned           m_share_size;
+        unsigned           m_share_batch;
+        mutex              m_mux;
 
         // for exchange with local search:
         unsigned           m_num_clauses;
@@ -83,13 +93,13 @@ namespace sat {
         void push_child(reslimit& rl);
 
         // reserve space
-        void reserve(unsigned num_owners, unsigned sz) { m_pool.reserve(num_owners, sz); }
+        void reserve(unsigned num_owners, unsigned sz);
 
         solver& get_solver(unsigned i) { return *m_solvers[i]; }
 
         void cancel_solver(unsigned i) { m_limits[i].cancel(); }
 
-        // exchange unit literals
+        // exchange unit literals, limit is the number of units s has already retrieved
         void exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out);
 
         // add clause to shared clause pool
@@ -24,6 +24,7 @@ Revision History:
 #include "sat/sat_elim_vars.h"
 #include "sat/sat_integrity_checker.h"
 #include "util/stopwatch.h"
+#include "util/thread_pool.h"
 #include "util/trace.h"
 
 namespace sat {
@@ -405,15 +406,15 @@ namespace sat {
        If c2 can self subsumed by c1, return true and store the literal that can be removed from c2 in l.
        Otherwise return false
     */
-    bool simplifier::subsumes1(clause const & c1, clause const & c2, literal & l) {
+    static bool subsumes1_core(svector<char> & marks, clause const & c1, clause const & c2, literal & l) {
         for (literal lit : c2) 
-            mark_visited(lit);
+            marks[lit.index()] = true;
 
         bool r = true;
         l = null_literal;
         for (literal lit : c1) {
-            if (!is_marked(lit)) {
-                if (l == null_literal && is_marked(~lit)) {
+            if (!marks[lit.index()]) {
+                if (l == null_literal && marks[(~lit).index()]) {
                     l = ~lit;
                 }
                 else {
@@ -425,10 +426,14 @@ namespace sat {
         }
 
         for (literal lit : c2) 
-            unmark_visited(lit);
+            marks[lit.index()] = false;
         return r;
     }
 
+    bool simplifier::subsumes1(clause const & c1, clause const & c2, literal & l) {
+        return subsumes1_core(m_visited, c1, c2, l);
+    }
+
     /**
        \brief Return the clauses subsumed by c1 and the clauses that can be subsumed resolved using c1.
        The collections is populated using the use list of target.
@@ -462,6 +467,49 @@ namespace sat {
         collect_subsumed1_core(c1, out, out_lits, literal(v, true));
     }
 
+    /**
+       \brief Collect the clauses subsumed by c1 and the clauses that can be subsumed resolved using c1
+       without modifying the simplifier state, so that several clauses can be processed concurrently.
+       The literal that can be removed is recomputed when the result is applied.
+    */
+    void simplifier::collect_subsumed1_par(clause const & c1, svector<char> & marks, clause_vector & out, unsigned & cost) const {
+        bool_var v = get_min_occ_var(c1);
+        for (literal target : { literal(v, false), literal(v, true) }) {
+            m_use_list.get(target).for_each([&](clause & c2) {
+                if (&c2 != &c1 &&
+                    c1.size() <= c2.size() &&
+                    approx_subset(c1.approx(), c2.approx())) {
+                    cost += c1.size() + c2.size();
+                    literal l;
+                    if (subsumes1_core(marks, c1, c2, l))
+                        out.push_back(&c2);
+                }
+            });
+        }
+    }
+
+    /**
+       \brief c1 subsumes c2 if l is null, otherwise remove l from c2 by subsumption resolution.
+    */
+    void simplifier::apply_subsumption1(clause & c1, clause & c2, literal l) {
+        if (l == null_literal) {
+            // c2 was subsumed
+            if (c1.is_learned() && !c2.is_learned()) {
+                s.set_learned(c1, false);
+            }
+            TRACE("subsumption", tout << c1 << " subsumed " << c2 << "\n";);
+            remove_clause(c2, false);
+            m_num_subsumed++;
+        }
+        else {
+            // subsumption resolution
+            TRACE("subsumption_resolution", tout << c1 << " sub-ref(" << l << ") " << c2 << "\n";);
+            elim_lit(c2, l);
+            m_num_sub_res++;
+            TRACE("subsumption_resolution", tout << "result: " << c2 << "\n";);
+        }
+    }
+
     /**
        \brief Perform backward subsumption and self-subsumption resolution using c1.
     */
@@ -470,32 +518,59 @@ namespace sat {
         m_bs_ls.reset();
         collect_subsumed1(c1, m_bs_cs, m_bs_ls);
         SASSERT(m_bs_cs.size() == m_bs_ls.size());
-        clause_vector::iterator it    = m_bs_cs.begin();
-        clause_vector::iterator end   = m_bs_cs.end();
-        literal_vector::iterator l_it = m_bs_ls.begin();
-        for (; it != end; ++it, ++l_it) {
-            clause & c2 = *(*it);
-            if (!c2.was_removed() && *l_it == null_literal) {
-                // c2 was subsumed
-                if (c1.is_learned() && !c2.is_learned()) {
-                    s.set_learned(c1, false);
-                }
-                TRACE("subsumption", tout << c1 << " subsumed " << c2 << "\n";);
-                remove_clause(c2, false);
-                m_num_subsumed++;
-            }
-            else if (!c2.was_removed()) {
-                // subsumption resolution
-                TRACE("subsumption_resolution", tout << c1 << " sub-ref(" << *l_it << ") " << c2 << "\n";);
-                elim_lit(c2, *l_it);
-                m_num_sub_res++;
-                TRACE("subsumption_resolution", tout << "result: " << c2 << "\n";);
-            }
+        for (unsigned i = 0; i < m_bs_cs.size(); ++i) {
+            clause & c2 = *m_bs_cs[i];
+            if (!c2.was_removed()) 
+                apply_subsumption1(c1, c2, m_bs_ls[i]);
             if (s.inconsistent())
                 break;
         }
     }
 
+    /**
+       \brief Backward subsumption for a batch of clauses from the subsumption queue.
+       Subsumed clauses are collected concurrently on the state before the batch, and
+       the results are applied in the order of the batch. Candidates are checked again
+       before they are applied since earlier clauses of the batch may have removed or
+       strengthened them.
+    */
+    void simplifier::par_back_subsumption1() {
+        clause_vector batch;
+        unsigned max_batch = 64 * m_num_threads;
+        while (!m_sub_todo.empty() && batch.size() < max_batch) {
+            clause & c = m_sub_todo.erase();
+            lbool r = cleanup_sub_todo(c);
+            if (r == l_undef)
+                return;
+            if (r == l_true)
+                batch.push_back(&c);
+        }
+        unsigned n = std::min(m_num_threads, batch.size());
+        vector<clause_vector> subsumed(batch.size());
+        unsigned_vector costs(batch.size(), 0u);
+        vector<svector<char>> marks(n);
+        thread_pool::run(n, [&](unsigned t) {
+            marks[t].resize(m_visited.size(), false);
+            for (unsigned i = t; i < batch.size(); i += n)
+                collect_subsumed1_par(*batch[i], marks[t], subsumed[i], costs[i]);
+        }, &s.rlimit());
+        for (unsigned i = 0; i < batch.size() && !s.inconsistent(); ++i) {
+            clause & c1 = *batch[i];
+            m_sub_counter -= costs[i];
+            for (clause* cp : subsumed[i]) {
+                clause & c2 = *cp;
+                literal l;
+                if (c1.was_removed())
+                    break;
+                if (c2.was_removed() || c1.size() > c2.size() || !subsumes1(c1, c2, l))
+                    continue;
+                apply_subsumption1(c1, c2, l);
+                if (s.inconsistent())
+                    break;
+            }
+        }
+    }
+
     void simplifier::back_subsumption1(literal l1, literal l2, bool learned) {
         m_dummy.set(l1, l2, learned);
         clause & c = *(m_dummy.get());
@@ -889,43 +964,63 @@ namespace sat {
             if (m_sub_counter < 0)
                 break;
 
-            clause & c = m_sub_todo.erase();
-
-            c.unmark_strengthened();
-            m_sub_counter--;
-            TRACE("subsumption", tout << "next: " << c << "\n";);
-            if (s.m_trail.size() > m_last_sub_trail_sz) {
-                unsigned sz0 = c.size();
-                if (cleanup_clause(c)) {
-                    remove_clause(c, true);
-                    continue;
-                }
-                unsigned sz = c.size();
-                switch (sz) {
-                case 0:
-                    s.set_conflict();
+            if (m_num_threads > 1 && m_sub_todo.size() >= 64 * m_num_threads) {
+                par_back_subsumption1();
+                if (s.inconsistent())
                     return;
-                case 1:
-                    c.restore(sz0);
-                    propagate_unit(c[0]);
-                    // unit propagation removes c
-                    continue;
-                case 2:
-                    TRACE("subsumption", tout << "clause became binary: " << c << "\n";);
-                    s.mk_bin_clause(c[0], c[1], c.is_learned());
-                    m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
-                    c.restore(sz0);
-                    remove_clause(c, sz != sz0);
-                    continue;
-                default:
-                    break;
-                }
+                continue;
             }
+
+            clause & c = m_sub_todo.erase();
+            lbool r = cleanup_sub_todo(c);
+            if (r == l_undef)
+                return;
+            if (r == l_false)
+                continue;
             TRACE("subsumption", tout << "using: " << c << "\n";);
             back_subsumption1(c);
         }
     }
 
+    /**
+       \brief Prepare clause c taken from the subsumption queue.
+       Return l_true if c can be used for backward subsumption, l_false if c was
+       simplified away and l_undef if it became empty.
+    */
+    lbool simplifier::cleanup_sub_todo(clause & c) {
+        c.unmark_strengthened();
+        m_sub_counter--;
+        TRACE("subsumption", tout << "next: " << c << "\n";);
+        if (s.m_trail.size() > m_last_sub_trail_sz) {
+            unsigned sz0 = c.size();
+            if (cleanup_clause(c)) {
+                remove_clause(c, true);
+                return l_false;
+            }
+            unsigned sz = c.size();
+            switch (sz) {
+            case 0:
+                s.set_conflict();
+                return l_undef;
+            case 1:
+                c.restore(sz0);
+                propagate_unit(c[0]);
+                // unit propagation removes c
+                return l_false;
+            case 2:
+                TRACE("subsumption", tout << "clause became binary: " << c << "\n";);
+                s.mk_bin_clause(c[0], c[1], c.is_learned());
+                m_sub_bin_todo.push_back(bin_clause(c[0], c[1], c.is_learned()));
+                c.restore(sz0);
+                remove_clause(c, sz != sz0);
+                return l_false;
+            default:
+                break;
+            }
+        }
+        return l_true;
+    }
+
     struct simplifier::blocked_clause_elim {
         class literal_lt {
             use_list const &   m_use_list;
@@ -1785,18 +1880,16 @@ namespace sat {
     /**
        \brief Collect clauses and binary clauses containing l.
     */
-    void simplifier::collect_clauses(literal l, clause_wrapper_vector & r) {
-        clause_use_list const & cs = m_use_list.get(l);
-        for (auto it = cs.mk_iterator(); !it.at_end(); it.next()) {
-            clause& c = it.curr();
-            if (!c.is_learned() && !c.was_removed()) {
+    void simplifier::collect_clauses(literal l, clause_wrapper_vector & r) const {
+        m_use_list.get(l).for_each([&](clause & c) {
+            if (!c.is_learned()) {
                 r.push_back(clause_wrapper(c));
                 SASSERT(r.back().contains(l));
                 SASSERT(r.back().size() == c.size());
             }
-        }
+        });
 
-        watch_list & wlist = get_wlist(~l);
+        watch_list const & wlist = get_wlist(~l);
         for (auto & w : wlist) {
             if (w.is_binary_non_learned_clause()) {
                 r.push_back(clause_wrapper(l, w.get_literal()));
@@ -1919,6 +2012,87 @@ namespace sat {
         }
     }
 
+    unsigned simplifier::num_irredundant_lits(literal l) const {
+        unsigned r = 0;
+        m_use_list.get(l).for_each([&](clause & c) {
+            if (!c.is_learned())
+                r += c.size();
+        });
+        return r;
+    }
+
+    bool simplifier::within_elim_cutoffs(unsigned num_pos, unsigned num_neg, unsigned before_lits) const {
+        if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
+            return false;
+        if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
+            s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
+            return false;
+        if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
+            s.m_clauses.size() <= m_res_cls_cutoff1)
+            return false;
+        return true;
+    }
+
+    /**
+       \brief Check, without modifying the simplifier state, whether v passes the bounds 
+       of try_eliminate: the cutoffs and the number of non-tautological resolvents.
+       marks is a scratch vector of the evaluating thread, cost is the effort
+       try_eliminate spends on rejecting v.
+    */
+    bool simplifier::eval_elim(bool_var v, svector<char> & marks, unsigned & cost) const {
+        if (value(v) != l_undef)
+            return false;
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        unsigned num_bin_pos = num_nonlearned_bin(pos_l);
+        unsigned num_bin_neg = num_nonlearned_bin(neg_l);
+        unsigned num_pos = m_use_list.get(pos_l).num_irredundant() + num_bin_pos;
+        unsigned num_neg = m_use_list.get(neg_l).num_irredundant() + num_bin_neg;
+        if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
+            return false;
+        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2 + num_irredundant_lits(pos_l) + num_irredundant_lits(neg_l);
+        if (!within_elim_cutoffs(num_pos, num_neg, before_lits))
+            return false;
+        clause_wrapper_vector pos_cls, neg_cls;
+        collect_clauses(pos_l, pos_cls);
+        collect_clauses(neg_l, neg_cls);
+        unsigned before_clauses = num_pos + num_neg;
+        unsigned after_clauses = 0;
+        for (clause_wrapper const & c1 : pos_cls) {
+            for (unsigned i = 0; i < c1.size(); ++i) 
+                marks[c1[i].index()] = true;
+            for (clause_wrapper const & c2 : neg_cls) {
+                cost += c1.size() + c2.size();
+                bool tautology = false;
+                for (unsigned i = 0; !tautology && i < c2.size(); ++i) 
+                    tautology = c2[i] != neg_l && marks[(~c2[i]).index()];
+                if (!tautology && ++after_clauses > before_clauses) 
+                    break;
+            }
+            for (unsigned i = 0; i < c1.size(); ++i) 
+                marks[c1[i].index()] = false;
+            if (after_clauses > before_clauses)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+       \brief Evaluate the elimination candidates vars[begin], ..., vars[end-1] concurrently.
+    */
+    void simplifier::par_eval_elim(bool_var_vector const & vars, unsigned begin, unsigned end, bool_vector & rejected, unsigned_vector & costs) {
+        unsigned n = std::min(m_num_threads, end - begin);
+        vector<svector<char>> marks(n);
+        thread_pool::run(n, [&](unsigned t) {
+            marks[t].resize(2 * s.num_vars(), false);
+            for (unsigned i = begin + t; i < end; i += n) {
+                unsigned cost = 0;
+                rejected[i] = !eval_elim(vars[i], marks[t], cost);
+                costs[i] = cost;
+            }
+        }, &s.rlimit());
+    }
+
     bool simplifier::try_eliminate(bool_var v) {
         if (value(v) != l_undef)
             return false;
@@ -1937,27 +2111,11 @@ namespace sat {
         if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
             return false;
 
-        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2;
-
-        for (auto it = pos_occs.mk_iterator(); !it.at_end(); it.next()) {
-            if (!it.curr().is_learned())
-                before_lits += it.curr().size();
-        }
-
-        for (auto it = neg_occs.mk_iterator(); !it.at_end(); it.next()) {
-            if (!it.curr().is_learned())
-                before_lits += it.curr().size();
-        }
+        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2 + num_irredundant_lits(pos_l) + num_irredundant_lits(neg_l);
 
         TRACE("sat_simplifier", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << " before_lits: " << before_lits << "\n";);
 
-        if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
-            return false;
-        if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
-            s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
-            return false;
-        if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
-            s.m_clauses.size() <= m_res_cls_cutoff1)
+        if (!within_elim_cutoffs(num_pos, num_neg, before_lits))
             return false;
 
         m_pos_cls.reset();
@@ -2087,18 +2245,53 @@ namespace sat {
         bool_var_vector vars;
         order_vars_for_elim(vars);
         sat::elim_vars elim_bdd(*this);
-        for (bool_var v : vars) {
+        // with several threads, candidates are evaluated in batches on the clauses before the batch.
+        // A rejected candidate is evaluated again only if an elimination in its batch changed its clauses.
+        bool par = m_num_threads > 1;
+        unsigned batch_size = 1024 * m_num_threads;
+        bool_vector rejected, dirty;
+        unsigned_vector costs;
+        bool all_dirty = false;
+        if (par) {
+            rejected.resize(vars.size(), false);
+            costs.resize(vars.size(), 0);
+        }
+        auto mark_dirty = [&](clause_wrapper_vector const & cs) {
+            for (clause_wrapper const & c : cs) 
+                for (unsigned i = 0; i < c.size(); ++i) 
+                    dirty[c[i].var()] = true;
+        };
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            bool_var v = vars[i];
+            if (par && i % batch_size == 0) {
+                par_eval_elim(vars, i, std::min(vars.size(), i + batch_size), rejected, costs);
+                dirty.reset();
+                dirty.resize(s.num_vars(), false);
+                all_dirty = false;
+            }
             checkpoint();
             if (m_elim_counter < 0) 
                 break;
             if (is_external(v)) {
                 // skip
             }
+            else if (par && rejected[i] && !dirty[v] && !all_dirty) {
+                m_elim_counter -= costs[i];
+                if (elim_vars_bdd_enabled() && elim_bdd(v)) {
+                    m_num_elim_vars++;
+                    all_dirty = true;
+                }
+            }
             else if (try_eliminate(v)) {
                 m_num_elim_vars++;
+                if (par) {
+                    mark_dirty(m_pos_cls);
+                    mark_dirty(m_neg_cls);
+                }
             }
             else if (elim_vars_bdd_enabled() && elim_bdd(v)) { 
                 m_num_elim_vars++;
+                all_dirty = true;
             }
         }
 
@@ -2134,6 +2327,7 @@ namespace sat {
         m_elim_vars               = p.elim_vars();
         m_elim_vars_bdd           = false && p.elim_vars_bdd(); // buggy?
         m_elim_vars_bdd_delay     = p.elim_vars_bdd_delay();
+        m_num_threads             = std::max(1u, p.simplify_threads());
         m_incremental_mode        = s.get_config().m_incremental && !p.override_incremental();
     }
 
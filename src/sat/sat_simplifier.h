@@ -105,6 +105,7 @@ namespace sat {
         bool                   m_elim_vars;
         bool                   m_elim_vars_bdd;
         unsigned               m_elim_vars_bdd_delay;
+        unsigned               m_num_threads;
 
         // stats
         unsigned               m_num_bce;
@@ -146,10 +147,14 @@ namespace sat {
         bool subsumes1(clause const & c1, clause const & c2, literal & l);
         void collect_subsumed1_core(clause const & c, clause_vector & out, literal_vector & out_lits, literal target);
         void collect_subsumed1(clause const & c, clause_vector & out, literal_vector & out_lits);
+        void collect_subsumed1_par(clause const & c, svector<char> & marks, clause_vector & out, unsigned & cost) const;
         clause_vector  m_bs_cs;
         literal_vector m_bs_ls;
+        void apply_subsumption1(clause & c1, clause & c2, literal l);
         void back_subsumption1(clause & c);
         void back_subsumption1(literal l1, literal l2, bool learned);
+        lbool cleanup_sub_todo(clause & c);
+        void par_back_subsumption1();
 
         literal get_min_occ_var0(clause const & c) const;
         bool subsumes0(clause const & c1, clause const & c2);
@@ -194,7 +199,11 @@ namespace sat {
         unsigned num_nonlearned_bin(literal l) const;
         unsigned get_to_elim_cost(bool_var v) const;
         void order_vars_for_elim(bool_var_vector & r);
-        void collect_clauses(literal l, clause_wrapper_vector & r);
+        void collect_clauses(literal l, clause_wrapper_vector & r) const;
+        bool within_elim_cutoffs(unsigned num_pos, unsigned num_neg, unsigned before_lits) const;
+        unsigned num_irredundant_lits(literal l) const;
+        bool eval_elim(bool_var v, svector<char> & marks, unsigned & cost) const;
+        void par_eval_elim(bool_var_vector const & vars, unsigned begin, unsigned end, bool_vector & rejected, unsigned_vector & costs);
         clause_wrapper_vector m_pos_cls;
         clause_wrapper_vector m_neg_cls;
         literal_vector m_new_cls;
@@ -20,12 +20,13 @@ Revision History:
 
 #include <cmath>
 #ifndef SINGLE_THREAD
-#include <thread>
+#include <mutex>
 #endif
 #include "util/luby.h"
 #include "util/trace.h"
 #include "util/max_cliques.h"
 #include "util/gparams.h"
+#include "util/thread_pool.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_integrity_checker.h"
 #include "sat/sat_lookahead.h"
@@ -55,6 +56,7 @@ namespace sat {
         m_probing(*this, p),
         m_mus(*this),
         m_binspr(*this),
+        m_vivify(*this),
         m_inconsistent(false),
         m_searching(false),
         m_conflict(justification(0)),
@@ -146,6 +148,7 @@ namespace sat {
         m_trail.reset();
         m_scopes.reset();
         mk_var(false, false);
+        m_is_copy = true;
 
         if (src.inconsistent()) {
             set_conflict();
@@ -341,6 +344,9 @@ namespace sat {
 
     clause* solver::mk_clause(unsigned num_lits, literal * lits, sat::status st) {
         m_model_is_current = false;
+        m_assumptions_reusable = false;
+        if (m_clause_cache && !m_searching && !st.is_redundant())
+            m_clause_cache->invalidate();
             
 
         DEBUG_CODE({
@@ -717,14 +723,21 @@ namespace sat {
 
     bool solver::should_defrag() {
         if (m_defrag_threshold > 0) --m_defrag_threshold;
-        return m_defrag_threshold == 0 && m_config.m_gc_defrag;
+        if (!m_config.m_gc_defrag) 
+            return false;
+        if (m_defrag_threshold == 0)
+            return true;
+        // compact early if half of the clause memory is fragmented into free lists.
+        clause_allocator const& a = cls_allocator();
+        return 2 * a.get_free_size() > a.get_reserved_size();
     }
 
     void solver::defrag_clauses() {
         m_defrag_threshold = 2;
         if (memory_pressure()) return;
         pop(scope_lvl());
-        IF_VERBOSE(2, verbose_stream() << "(sat-defrag)\n");
+        IF_VERBOSE(2, verbose_stream() << "(sat-defrag :free " << cls_allocator().get_free_size() 
+                   << " :reserved " << cls_allocator().get_reserved_size() << ")\n");
         clause_allocator& alloc = m_cls_allocator[!m_cls_allocator_idx];
         ptr_vector<clause> new_clauses, new_learned;
         for (clause* c : m_clauses) c->unmark_used();
@@ -734,7 +747,8 @@ namespace sat {
         for (unsigned i = 0; i < num_vars(); ++i) vars.push_back(i);
         std::stable_sort(vars.begin(), vars.end(), cmp_activity(*this));
         literal_vector lits;
-        for (bool_var v : vars) lits.push_back(literal(v, false)), lits.push_back(literal(v, true));
+        // propagation of v under its saved phase visits the watch list of literal(v, !m_phase[v]) first.
+        for (bool_var v : vars) lits.push_back(literal(v, !m_phase[v])), lits.push_back(literal(v, m_phase[v]));
         // walk clauses, reallocate them in an order that defragments memory and creates locality.
         for (literal lit : lits) {
             watch_list& wlist = m_watches[lit.index()];
@@ -1323,10 +1337,17 @@ namespace sat {
     // -----------------------
     lbool solver::check(unsigned num_lits, literal const* lits) {
         init_reason_unknown();
-        pop_to_base_level();
+        bool reuse = can_reuse_assumptions(num_lits, lits);
+        m_assumptions_reusable = false;
+        m_check_assumptions.reset();
+        m_check_assumptions.append(num_lits, lits);
+        if (reuse)
+            pop(scope_lvl() - m_search_lvl);
+        else
+            pop_to_base_level();
         m_stats.m_units = init_trail_size();
         IF_VERBOSE(2, verbose_stream() << "(sat.solver)\n";);
-        SASSERT(at_base_lvl());
+        SASSERT(reuse || at_base_lvl());
 
         if (m_config.m_ddfw_search) {
             m_cleaner(true);
@@ -1347,7 +1368,7 @@ namespace sat {
         }
         flet<bool> _searching(m_searching, true);
         m_clone = nullptr;
-        if (m_mc.empty() && gparams::get_ref().get_bool("model_validate", false)) {
+        if (m_mc.empty() && m_config.m_model_validate) {
             
             m_clone = alloc(solver, m_no_drat_params, m_rlimit);
             m_clone->copy(*this);
@@ -1355,10 +1376,21 @@ namespace sat {
         }
         try {
             init_search();
-            if (check_inconsistent()) return l_false;
-            propagate(false);
-            if (check_inconsistent()) return l_false;
-            init_assumptions(num_lits, lits);
+            if (reuse) {
+                extend_assumptions(num_lits, lits);
+            }
+            else {
+                if (check_inconsistent()) return l_false;
+                propagate(false);
+                if (check_inconsistent()) return l_false;
+                if (use_clause_cache()) {
+                    if (!m_clause_cache)
+                        m_clause_cache = alloc(clause_cache, *this, m_config.m_learned_cache_file.str());
+                    m_clause_cache->load();
+                    if (check_inconsistent()) return l_false;
+                }
+                init_assumptions(num_lits, lits);
+            }
             propagate(false);
             if (check_inconsistent()) return l_false;
             if (m_config.m_force_cleanup) do_cleanup(true);
@@ -1386,8 +1418,10 @@ namespace sat {
                 m_restart_threshold = m_config.m_burst_search;
                 lbool r = bounded_search();
                 log_stats();
-                if (r != l_undef) 
+                if (r != l_undef) {
+                    m_assumptions_reusable = r == l_true;
                     return r;
+                }
                 
                 pop_reinit(scope_lvl());
                 m_conflicts_since_restart = 0;
@@ -1396,6 +1430,7 @@ namespace sat {
 
             lbool is_sat = search();
             log_stats();
+            m_assumptions_reusable = is_sat != l_false;
             return is_sat;
         }
         catch (const abort_solver &) {
@@ -1404,6 +1439,27 @@ namespace sat {
         }
     }
 
+    /**
+       \brief The learned clause cache is used for plain clause sets only: clauses learned with
+       an extension, under user scopes or by a parallel worker cannot be validated on their own.
+       Copies (parallel and core minimization workers, model validation clones) are created with
+       the parameters of their source, they must not load or overwrite its cache.
+    */
+    bool solver::use_clause_cache() const {
+        return
+            m_config.m_learned_cache_file.is_non_empty_string() &&
+            !m_ext &&
+            !m_config.m_drat &&
+            m_user_scope_literals.empty() &&
+            !m_par &&
+            !m_is_copy;
+    }
+
+    void solver::save_clause_cache() {
+        if (m_clause_cache && use_clause_cache())
+            m_clause_cache->save();
+    }
+
     bool solver::should_cancel() {
         if (limit_reached() || memory_exceeded()) {
             return true;
@@ -1595,13 +1651,7 @@ namespace sat {
             return l_undef;
         }
 
-        vector<std::thread> threads(num_threads);
-        for (int i = 0; i < num_threads; ++i) {
-            threads[i] = std::thread([&, i]() { worker_thread(i); });
-        }
-        for (auto & th : threads) {
-            th.join();
-        }
+        thread_pool::run(num_threads, [&](unsigned i) { worker_thread(i); }, &rlimit());
         
         if (IS_AUX_SOLVER(finished_id)) {
             m_stats = par.get_solver(finished_id).m_stats;
@@ -1881,6 +1931,57 @@ namespace sat {
         SASSERT(m_search_lvl == 1);
     }
 
+    /**
+       \brief Check if the next check can keep the search level of the previous check.
+       This is the case if no clauses were added since, the user scopes are the same and
+       every assumption of the previous check is among the new assumptions. The assignment
+       at the search level is then a consequence of the new assumptions.
+       Only the assumptions passed to check are compared: m_assumption_set may also hold
+       the literals of a minimized core.
+    */
+    bool solver::can_reuse_assumptions(unsigned num_lits, literal const* lits) {
+        if (!m_assumptions_reusable || !m_config.m_assumptions_reuse || m_ext || m_config.m_drat)
+            return false;
+        if (m_config.m_ddfw_search || m_config.m_prob_search || m_config.m_local_search ||
+            m_config.m_num_threads > 1 || m_config.m_local_search_threads > 0 || m_config.m_ddfw_threads > 0)
+            return false;
+        if (inconsistent() || m_search_lvl != 1 || scope_lvl() < m_search_lvl)
+            return false;
+        // the model validation clones the solver at the base level
+        if (m_config.m_model_validate)
+            return false;
+        for (unsigned i = 0; i < num_lits; ++i)
+            if (!is_marked_lit(lits[i]))
+                mark_lit(lits[i]);
+        bool contained = true;
+        for (literal lit : m_check_assumptions)
+            contained &= is_marked_lit(lit);
+        for (unsigned i = 0; i < num_lits; ++i)
+            if (is_marked_lit(lits[i]))
+                unmark_lit(lits[i]);
+        return contained;
+    }
+
+    /**
+       \brief Add the assumptions that are not yet assigned at the search level.
+    */
+    void solver::extend_assumptions(unsigned num_lits, literal const* lits) {
+        SASSERT(scope_lvl() == 1);
+        m_search_lvl = scope_lvl();
+        m_stats.m_assumption_reuse++;
+        m_stats.m_assumption_reuse_lits += m_trail.size() - m_scopes[0].m_trail_lim;
+        TRACE("sat", tout << "extend assumptions " << m_assumptions << " with " << literal_vector(num_lits, lits) << "\n";);
+        for (unsigned i = 0; !inconsistent() && i < num_lits; ++i) {
+            literal lit = lits[i];
+            if (m_assumption_set.contains(lit))
+                continue;
+            set_external(lit.var());
+            SASSERT(is_external(lit.var()));
+            add_assumption(lit);
+            assign_scoped(lit);
+        }
+    }
+
     void solver::update_min_core() {
         if (!m_min_core_valid || m_core.size() < m_min_core.size()) {
             m_min_core.reset();
@@ -1890,6 +1991,7 @@ namespace sat {
     }
 
     void solver::reset_assumptions() {
+        m_assumptions_reusable = false;
         m_assumptions.reset();
         m_assumption_set.reset();
         m_ext_assumption_set.reset();
@@ -2082,6 +2184,12 @@ namespace sat {
         CASSERT("sat_simplify_bug", check_invariant());
         m_asymm_branch(false);
 
+        if (m_config.m_vivify && !inconsistent()) {
+            m_vivify();
+            CASSERT("sat_missed_prop", check_missed_propagation());
+            CASSERT("sat_simplify_bug", check_invariant());
+        }
+
         if (m_config.m_lookahead_simplify && !m_ext) {
             lookahead lh(*this);
             lh.simplify(true);
@@ -2700,6 +2808,8 @@ namespace sat {
         if (!is_marked(var)) {
             mark(var);
             m_unmark.push_back(var);
+            if (lvl(var) == m_conflict_lvl)
+                m_core_pending++;
             if (is_assumption(antecedent)) {
                 m_core.push_back(antecedent);
             }
@@ -2786,6 +2896,7 @@ namespace sat {
 
         unsigned old_size = m_unmark.size();
         int idx = skip_literals_above_conflict_level();
+        m_core_pending = 0;
 
         literal consequent = m_not_l;
         if (m_not_l != null_literal) {
@@ -2808,6 +2919,10 @@ namespace sat {
         int init_sz = init_trail_size();
         while (true) {
             process_consequent_for_unsat_core(consequent, js);
+            // the remaining trail cannot contribute to the core once all marked literals
+            // at the conflict level are resolved.
+            if (m_core_pending == 0)
+                break;
             while (idx >= init_sz) {
                 consequent = m_trail[idx];
                 if (is_marked(consequent.var()) && lvl(consequent) == m_conflict_lvl)
@@ -2818,6 +2933,7 @@ namespace sat {
                 break;
             }
             SASSERT(lvl(consequent) == m_conflict_lvl);
+            m_core_pending--;
             js = m_justification[consequent.var()];
             idx--;
         }
@@ -2840,6 +2956,7 @@ namespace sat {
             // apply optional clause minimization by detecting subsumed literals.
             // initial experiment suggests it has no effect.
             m_mus(); // ignore return value on cancelation.
+            m_assumptions_reusable = false;
             set_model(m_mus.get_model(), !m_mus.get_model().empty());
             IF_VERBOSE(2, verbose_stream() << "(sat.core: " << m_core << ")\n";);
         }
@@ -3849,10 +3966,12 @@ namespace sat {
         m_simplifier.collect_statistics(st);
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
+        m_vivify.collect_statistics(st);
         m_probing.collect_statistics(st);
         if (m_ext) m_ext->collect_statistics(st);
         if (m_local_search) m_local_search->collect_statistics(st);
         if (m_cut_simplifier) m_cut_simplifier->collect_statistics(st);
+        if (m_clause_cache) m_clause_cache->collect_statistics(st);
         st.copy(m_aux_stats);
     }
 
@@ -3861,6 +3980,7 @@ namespace sat {
         m_cleaner.reset_statistics();
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
+        m_vivify.reset_statistics();
         m_probing.reset_statistics();
         m_aux_stats.reset();
     }
@@ -4850,6 +4970,8 @@ namespace sat {
         st.update("sat elim bool vars bdd", m_elim_var_bdd);
         st.update("sat backjumps", m_backjumps);
         st.update("sat backtracks", m_backtracks);
+        st.update("sat assumption reuse", m_assumption_reuse);
+        st.update("sat assumption reuse lits", m_assumption_reuse_lits);
     }
 
     void stats::reset() {
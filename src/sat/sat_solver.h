@@ -42,9 +42,11 @@ Revision History:
 #include "sat/sat_probing.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_binspr.h"
+#include "sat/sat_vivify.h"
 #include "sat/sat_drat.h"
 #include "sat/sat_parallel.h"
 #include "sat/sat_local_search.h"
+#include "sat/sat_clause_cache.h"
 #include "sat/sat_solver_core.h"
 
 namespace pb {
@@ -78,6 +80,8 @@ namespace sat {
         unsigned m_units;
         unsigned m_backtracks;
         unsigned m_backjumps;
+        unsigned m_assumption_reuse;
+        unsigned m_assumption_reuse_lits;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -98,6 +102,8 @@ namespace sat {
         stats                   m_stats;
         scoped_ptr<extension>   m_ext;
         scoped_ptr<cut_simplifier> m_cut_simplifier;
+        scoped_ptr<clause_cache> m_clause_cache;
+        bool                    m_is_copy { false }; // clauses were copied from another solver, see use_clause_cache
         parallel*               m_par;
         drat                    m_drat;          // DRAT for generating proofs
         clause_allocator        m_cls_allocator[2];
@@ -114,6 +120,7 @@ namespace sat {
         bool                    m_is_probing { false };
         mus                     m_mus;           // MUS for minimal core extraction
         binspr                  m_binspr;
+        vivify                  m_vivify;
         bool                    m_inconsistent;
         bool                    m_searching;
         // A conflict is usually a single justification. That is, a justification
@@ -194,6 +201,9 @@ namespace sat {
         literal_set             m_assumption_set;   // set of enabled assumptions
         literal_set             m_ext_assumption_set;   // set of enabled assumptions
         literal_vector          m_core;             // unsat core
+        unsigned                m_core_pending { 0 }; // marked literals at the conflict level not yet resolved during core extraction
+        bool                    m_assumptions_reusable { false }; // the assignment of the assumptions of the last check is still valid
+        literal_vector          m_check_assumptions; // assumptions passed to the last check
 
         unsigned                m_par_id;        
         unsigned                m_par_limit_in;
@@ -211,6 +221,7 @@ namespace sat {
         friend class integrity_checker;
         friend class cleaner;
         friend class asymm_branch;
+        friend class vivify;
         friend class big;
         friend class binspr;
         friend class drat;
@@ -237,6 +248,7 @@ namespace sat {
         friend class lut_finder;
         friend class npn3_finder;
         friend class proof_trim;
+        friend class clause_cache;
     public:
         solver(params_ref const & p, reslimit& l);
         ~solver() override;
@@ -493,6 +505,9 @@ namespace sat {
     public:
         lbool check(unsigned num_lits = 0, literal const* lits = nullptr);
 
+        // store the learned clauses in the learned clause cache, called by the owner of the solver once it is done.
+        void save_clause_cache();
+
         // retrieve model if solver return sat
         model const & get_model() const { return m_model; }
         bool model_is_current() const { return m_model_is_current; }
@@ -564,6 +579,9 @@ namespace sat {
         bool           m_min_core_valid { false };
         void init_reason_unknown() { m_reason_unknown = "no reason given"; }
         void init_assumptions(unsigned num_lits, literal const* lits);
+        bool can_reuse_assumptions(unsigned num_lits, literal const* lits);
+        void extend_assumptions(unsigned num_lits, literal const* lits);
+        bool use_clause_cache() const;
         void reassert_min_core();
         void update_min_core();
         void resolve_weighted();
@@ -612,6 +630,7 @@ namespace sat {
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
+        void gc_tier();
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
         bool can_delete(clause const & c) const;
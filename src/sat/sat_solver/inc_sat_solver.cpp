@@ -105,6 +105,11 @@ public:
         m_solver.set_incremental(incremental_mode && !override_incremental());
     }
 
+    ~inc_sat_solver() override {
+        // the learned clauses of all checks are stored once, when the solver is done
+        m_solver.save_clause_cache();
+    }
+
     bool override_incremental() const {
         sat_simplifier_params p(m_params);
         return p.override_incremental();
@@ -179,9 +184,7 @@ public:
     }
 
     lbool check_sat_core(unsigned sz, expr * const * assumptions) override {
-        m_solver.pop_to_base_level();
         m_core.reset();
-        if (m_solver.inconsistent()) return l_false;
         expr_ref_vector _assumptions(m);
         obj_map<expr, expr*> asm2fml;
         for (unsigned i = 0; i < sz; ++i) {
@@ -198,6 +201,12 @@ public:
             }
         }
 
+        // keep the assumption level of the previous check when no clauses are added,
+        // so that the sat solver can reuse it if the new assumptions extend the old ones.
+        if (!can_keep_assumptions(sz, assumptions) || m_solver.inconsistent())
+            m_solver.pop_to_base_level();
+        if (m_solver.inconsistent()) return l_false;
+
         TRACE("sat", tout << _assumptions << "\n";);
         m_dep2asm.reset();
         lbool r = internalize_formulas();
@@ -245,6 +254,26 @@ public:
         return r;
     }
 
+    /**
+       \brief The sat solver can stay above the base level if the check adds neither clauses
+       nor variables, i.e., all assumptions are literals over atoms that are already mapped.
+    */
+    bool can_keep_assumptions(unsigned sz, expr * const * assumptions) const {
+        if (m_fmls_head != m_fmls.size() || !m_is_cnf)
+            return false;
+        auto is_mapped = [&](expr* e) {
+            m.is_not(e, e);
+            return is_uninterp_const(e) && m_map.to_bool_var(e) != sat::null_bool_var;
+        };
+        for (unsigned i = 0; i < sz; ++i)
+            if (!is_mapped(assumptions[i]))
+                return false;
+        for (unsigned i = 0; i < get_num_assumptions(); ++i)
+            if (!is_mapped(get_assumption(i)))
+                return false;
+        return true;
+    }
+
     void push() override {
         try {
             internalize_formulas();
@@ -0,0 +1,217 @@
+/*++
+
+  Module Name:
+
+   sat_vivify.cpp
+
+  Abstract:
+   
+    Vivification of learned clauses.
+
+  --*/
+
+#include "sat/sat_vivify.h"
+#include "sat/sat_solver.h"
+#include "util/stopwatch.h"
+#include "util/trace.h"
+
+namespace sat {
+
+    vivify::vivify(solver& s):
+        s(s),
+        m_counter(0) {
+        reset_statistics();
+    }
+
+    struct vivify::report {
+        vivify&   m_vivify;
+        stopwatch m_watch;
+        unsigned  m_vivified;
+        unsigned  m_elim_literals;
+        unsigned  m_deleted;
+        report(vivify& v):
+            m_vivify(v),
+            m_vivified(v.m_vivified),
+            m_elim_literals(v.m_elim_literals),
+            m_deleted(v.m_deleted) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(2,
+                       verbose_stream() << " (sat-vivify";
+                       verbose_stream() << " :vivified " << (m_vivify.m_vivified - m_vivified);
+                       verbose_stream() << " :elim-literals " << (m_vivify.m_elim_literals - m_elim_literals);
+                       if (m_vivify.m_deleted > m_deleted) verbose_stream() << " :deleted " << (m_vivify.m_deleted - m_deleted);
+                       verbose_stream() << mem_stat();
+                       verbose_stream() << m_watch << ")\n";);
+        }
+    };
+
+    /**
+       \brief 0 for tier 2, 1 for core clauses, 2 for local clauses.
+     */
+    unsigned vivify::tier(clause const& c) const {
+        if (c.glue() <= s.m_config.m_gc_small_lbd)
+            return 1;
+        if (c.glue() <= s.m_config.m_gc_tier2_lbd)
+            return 0;
+        return 2;
+    }
+
+    struct vivify::priority_lt {
+        vivify& v;
+        priority_lt(vivify& v): v(v) {}
+        bool operator()(clause const* c1, clause const* c2) const {
+            unsigned t1 = v.tier(*c1), t2 = v.tier(*c2);
+            if (t1 != t2) return t1 < t2;
+            if (c1->was_used() != c2->was_used()) return c1->was_used();
+            if (c1->glue() != c2->glue()) return c1->glue() < c2->glue();
+            return c1->size() < c2->size();
+        }
+    };
+
+    void vivify::operator()() {
+        s.propagate(false); // must propagate, since it uses s.push()
+        if (s.inconsistent() || s.m_learned.empty())
+            return;
+        ++m_calls;
+        SASSERT(s.at_base_lvl());
+        report rpt(*this);
+        bool_vector saved_phase(s.m_phase);
+        flet<bool> _is_probing(s.m_is_probing, true);
+
+        clause_vector& clauses = s.m_learned;
+        std::stable_sort(clauses.begin(), clauses.end(), priority_lt(*this));
+        m_counter = s.m_config.m_vivify_limit;
+        clause_vector::iterator it  = clauses.begin();
+        clause_vector::iterator it2 = it;
+        clause_vector::iterator end = clauses.end();
+        try {
+            for (; it != end; ++it) {
+                clause& c = *(*it);
+                if (m_counter < 0 || s.inconsistent() || c.was_removed() || c.frozen()) {
+                    *it2 = *it;
+                    ++it2;
+                    continue;
+                }
+                s.checkpoint();
+                if (!process(c))
+                    continue; // clause was removed
+                *it2 = *it;
+                ++it2;
+            }
+            clauses.set_end(it2);
+        }
+        catch (solver_exception & ex) {
+            // put m_learned in a consistent state...
+            for (; it != end; ++it, ++it2) {
+                *it2 = *it;
+            }
+            clauses.set_end(it2);
+            s.m_phase = saved_phase;
+            throw ex;
+        }
+        s.m_phase = saved_phase;
+        if (!s.inconsistent())
+            s.propagate(false);
+    }
+
+    /**
+       \brief vivify c, return false if c was deleted.
+     */
+    bool vivify::process(clause& c) {
+        SASSERT(s.scope_lvl() == 0);
+        SASSERT(!s.inconsistent());
+        for (literal l : c) {
+            if (s.value(l) == l_true) {
+                ++m_deleted;
+                s.detach_clause(c);
+                s.del_clause(c);
+                return false;
+            }
+        }
+        m_counter -= c.size();
+
+        // clause must not be used for propagation
+        scoped_detach scoped_d(s, c);
+        unsigned sz = c.size();
+        unsigned trail_sz = s.m_trail.size();
+        m_new.reset();
+        s.push();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal l = c[i];
+            lbool val = s.value(l);
+            if (val == l_false)
+                continue;
+            m_new.push_back(l);
+            if (val == l_true)
+                break;
+            s.assign_scoped(~l);
+            s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
+            if (s.inconsistent())
+                break;
+        }
+        m_counter -= s.m_trail.size() - trail_sz;
+        s.pop(1);
+        SASSERT(!s.inconsistent());
+
+        unsigned new_sz = m_new.size();
+        if (new_sz == sz)
+            return true;
+        TRACE("sat_vivify", tout << c << " -> " << m_new << "\n";);
+        // move the remaining literals to the front, keeping c a permutation
+        // of the original clause (needed when logging the shrink to DRAT)
+        for (unsigned i = 0; i < new_sz; ++i) {
+            unsigned j = i;
+            while (c[j] != m_new[i])
+                ++j;
+            std::swap(c[i], c[j]);
+        }
+        return re_attach(scoped_d, c, new_sz);
+    }
+
+    bool vivify::re_attach(scoped_detach& scoped_d, clause& c, unsigned new_sz) {
+        VERIFY(s.m_trail.size() == s.m_qhead);
+        unsigned old_sz = c.size();
+        ++m_vivified;
+        m_elim_literals += old_sz - new_sz;
+        switch (new_sz) {
+        case 0:
+            s.set_conflict();
+            return false;
+        case 1:
+            ++m_units;
+            s.assign_unit(c[0]);
+            s.propagate_core(false);
+            scoped_d.del_clause();
+            return false;
+        case 2:
+            VERIFY(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
+            s.mk_bin_clause(c[0], c[1], c.is_learned());
+            if (s.m_trail.size() > s.m_qhead) s.propagate_core(false);
+            scoped_d.del_clause();
+            return false;
+        default:
+            s.shrink(c, old_sz, new_sz);
+            return true;
+        }
+    }
+
+    void vivify::collect_statistics(statistics& st) const {
+        st.update("sat vivify calls", m_calls);
+        st.update("sat vivified clauses", m_vivified);
+        st.update("sat vivify elim literals", m_elim_literals);
+        st.update("sat vivify deleted", m_deleted);
+        st.update("sat vivify units", m_units);
+    }
+
+    void vivify::reset_statistics() {
+        m_calls = 0;
+        m_vivified = 0;
+        m_elim_literals = 0;
+        m_deleted = 0;
+        m_units = 0;
+    }
+}
@@ -0,0 +1,61 @@
+/*++
+
+  Module Name:
+
+   sat_vivify.h
+
+  Abstract:
+   
+    Vivification of learned clauses.
+
+    A learned clause C = l1 or ... or ln is shortened by assigning ~l1, ~l2, ...
+    at a fresh scope and propagating (with C detached):
+    - a conflict after ~l1, ..., ~li gives the clause l1 or ... or li,
+    - a literal li that becomes true gives the clause l1 or ... or li
+      (restricted to the literals assigned so far),
+    - a literal li that becomes false is removed from C.
+
+    Clauses of tier 2 (LBD above gc.small_lbd and at most gc.tier2_lbd) that
+    were used since the last round are processed first, then the other tier 2,
+    core and local clauses, each by increasing LBD, until the propagation
+    budget sat.vivify.limit is exhausted.
+
+  --*/
+#pragma once
+
+#include "util/statistics.h"
+#include "sat/sat_clause.h"
+#include "sat/sat_types.h"
+
+namespace sat {
+    class solver;
+    class scoped_detach;
+
+    class vivify {
+        struct report;
+        struct priority_lt;
+
+        solver&        s;
+        int64_t        m_counter;
+        literal_vector m_new;
+
+        // stats
+        unsigned       m_calls;
+        unsigned       m_vivified;
+        unsigned       m_elim_literals;
+        unsigned       m_deleted;
+        unsigned       m_units;
+
+        unsigned tier(clause const& c) const;
+        bool process(clause& c);
+        bool re_attach(scoped_detach& scoped_d, clause& c, unsigned new_sz);
+
+    public:
+        vivify(solver& s);
+
+        void operator()();
+
+        void collect_statistics(statistics& st) const;
+        void reset_statistics();
+    };
+}
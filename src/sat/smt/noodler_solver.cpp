@@ -0,0 +1,517 @@
+/*++
+
+Module Name:
+
+    noodler_solver.cpp
+
+Abstract:
+
+    String theory plugin for the euf core driving the noodler decision procedure.
+
+--*/
+
+#include "ast/ast_util.h"
+#include "sat/smt/noodler_solver.h"
+#include "sat/smt/euf_solver.h"
+#include "smt/theory_str_noodler/bounded_search.h"
+#include "smt/theory_str_noodler/decision_procedure.h"
+#include "smt/theory_str_noodler/util.h"
+
+namespace noodler {
+
+    using smt::noodler::BasicTerm;
+    using smt::noodler::BasicTermType;
+    using smt::noodler::Predicate;
+    using smt::noodler::PredicateType;
+
+    solver::solver(euf::solver& ctx, theory_id id):
+        th_euf_solver(ctx, symbol("noodler"), id),
+        m_util_s(m),
+        m_util_a(m),
+        m_rewrite(m),
+        m_axioms(m),
+        m_pinned(m) {
+    }
+
+    sat::literal solver::internalize(expr* e, bool sign, bool root) {
+        SASSERT(m.is_bool(e));
+        if (!visit_rec(m, e, sign, root))
+            return sat::null_literal;
+        auto lit = expr2literal(e);
+        if (sign)
+            lit.neg();
+        return lit;
+    }
+
+    void solver::internalize(expr* e) {
+        visit_rec(m, e, false, false);
+    }
+
+    bool solver::visited(expr* e) {
+        euf::enode* n = expr2enode(e);
+        return n && (!m_util_s.is_string(e->get_sort()) || n->is_attached_to(get_id()));
+    }
+
+    bool solver::visit(expr* e) {
+        if (visited(e))
+            return true;
+        // regular expressions are converted to automata, they do not take part in the e-graph
+        if (m_util_s.is_re(e))
+            return true;
+        if (!is_app(e) || to_app(e)->get_family_id() != get_id()) {
+            ctx.internalize(e);
+            if (m_util_s.is_string(e->get_sort()))
+                ensure_var(expr2enode(e));
+            return true;
+        }
+        m_stack.push_back(sat::eframe(e));
+        return false;
+    }
+
+    bool solver::post_visit(expr* e, bool sign, bool root) {
+        euf::enode* n = expr2enode(e);
+        if (!n) {
+            bool has_re_arg = std::any_of(to_app(e)->begin(), to_app(e)->end(), [&](expr* arg) { return m_util_s.is_re(arg); });
+            n = mk_enode(e, has_re_arg);
+        }
+        if (m_util_s.is_string(e->get_sort()))
+            ensure_var(n);
+        expr* s = nullptr, * r = nullptr;
+        if (m_util_s.str.is_length(e))
+            add_length_axioms(e);
+        else if (m_util_s.str.is_in_re(e, s, r))
+            ensure_term_var(s);
+        else if (!is_supported(e)) {
+            TRACE("noodler", tout << "unsupported " << mk_pp(e, m) << "\n";);
+            ctx.push(value_trail<unsigned>(m_num_unsupported));
+            ++m_num_unsupported;
+        }
+        return true;
+    }
+
+    void solver::apply_sort_cnstr(euf::enode* n, sort* s) {
+        if (!m_util_s.is_string(s)) {
+            // sequences of other sorts and regular expressions outside of str.in_re
+            ctx.push(value_trail<unsigned>(m_num_unsupported));
+            ++m_num_unsupported;
+            return;
+        }
+        ensure_var(n);
+        expr* e = n->get_expr();
+        if (is_app(e) && to_app(e)->get_num_args() > 0)
+            ensure_term_var(e);
+    }
+
+    void solver::ensure_var(euf::enode* n) {
+        if (n->is_attached_to(get_id()))
+            return;
+        theory_var v = mk_var(n);
+        ctx.attach_th_var(n, this, v);
+    }
+
+    /**
+     * Represent the term @p e by a fresh string variable and assert that they are equal. The decision
+     * procedure works over variables only, the e-graph takes care of the congruences of the term itself.
+     */
+    void solver::ensure_term_var(expr* e) {
+        if (is_app(e) && to_app(e)->get_num_args() == 0 && !m_util_s.str.is_string(e))
+            return;
+        expr* v = nullptr;
+        if (!m_term2var.find(e, v)) {
+            v = m_util_s.mk_skolem(m.mk_fresh_var_name("strvar"), 0, nullptr, m_util_s.mk_string_sort());
+            m_pinned.push_back(e);
+            m_pinned.push_back(v);
+            m_term2var.insert(e, v);
+        }
+        push_axiom(mk_eq(e, v));
+    }
+
+    bool solver::is_supported(expr* e) const {
+        if (m_util_s.is_string(e->get_sort()) && is_app(e) && to_app(e)->get_num_args() == 0)
+            return true;
+        return m_util_s.str.is_concat(e) || m_util_s.str.is_length(e) || m_util_s.str.is_in_re(e);
+    }
+
+    void solver::push_axiom(expr* e) {
+        m_axioms.push_back(e);
+        ctx.push(push_back_vector<expr_ref_vector>(m_axioms));
+    }
+
+    /**
+     * len(s) >= 0, len("w") = |w| and len(s1 ++ ... ++ sn) = len(s1) + ... + len(sn).
+     */
+    void solver::add_length_axioms(expr* len) {
+        expr* s = nullptr;
+        zstring str;
+        VERIFY(m_util_s.str.is_length(len, s));
+        push_axiom(m_util_a.mk_ge(len, m_util_a.mk_int(0)));
+        if (m_util_s.str.is_string(s, str))
+            push_axiom(m.mk_eq(len, m_util_a.mk_int(str.length())));
+        else if (m_util_s.str.is_empty(s))
+            push_axiom(m.mk_eq(len, m_util_a.mk_int(0)));
+        else if (m_util_s.str.is_concat(s)) {
+            expr_ref_vector lens(m);
+            for (expr* arg : *to_app(s))
+                lens.push_back(m_util_s.str.mk_length(arg));
+            push_axiom(m.mk_eq(len, m_util_a.mk_add(lens.size(), lens.data())));
+        }
+    }
+
+    bool solver::unit_propagate() {
+        if (m_axioms_qhead == m_axioms.size())
+            return false;
+        ctx.push(value_trail<unsigned>(m_axioms_qhead));
+        for (; m_axioms_qhead < m_axioms.size(); ++m_axioms_qhead)
+            add_unit(mk_literal(m_axioms.get(m_axioms_qhead)));
+        return true;
+    }
+
+    void solver::asserted(sat::literal l) {
+        expr* e = ctx.bool_var2expr(l.var());
+        expr* s = nullptr, * r = nullptr;
+        if (!m_util_s.str.is_in_re(e, s, r))
+            return;
+        m_memberships.push_back(expr_pair_flag(expr_ref(s, m), expr_ref(r, m), !l.sign()));
+        ctx.push(push_back_vector<vector<expr_pair_flag>>(m_memberships));
+    }
+
+    void solver::new_eq_eh(euf::th_eq const& eq) {
+        m_word_eqs.push_back(expr_pair(expr_ref(var2expr(eq.v1()), m), expr_ref(var2expr(eq.v2()), m)));
+        ctx.push(push_back_vector<vector<expr_pair>>(m_word_eqs));
+    }
+
+    void solver::new_diseq_eh(euf::th_eq const& eq) {
+        expr* a = nullptr, * b = nullptr;
+        VERIFY(m.is_eq(eq.eq(), a, b));
+        m_word_diseqs.push_back(expr_pair(expr_ref(a, m), expr_ref(b, m)));
+        ctx.push(push_back_vector<vector<expr_pair>>(m_word_diseqs));
+    }
+
+    /**
+     * A variable is length sensitive if the length of some term of its equivalence class is used.
+     */
+    bool solver::is_length_sensitive(expr* var) const {
+        euf::enode* n = expr2enode(var);
+        return n && get_length(n);
+    }
+
+    /**
+     * Get the length term of the equivalence class of @p n, nullptr if the length is not used.
+     */
+    euf::enode* solver::get_length(euf::enode* n) const {
+        for (euf::enode* p : euf::enode_parents(n->get_root()))
+            if (m_util_s.str.is_length(p->get_expr()))
+                return p;
+        return nullptr;
+    }
+
+    /**
+     * Values are known for the classes of the instance that contain a literal (see add_value()), the
+     * instance has a model once this holds for all its variables.
+     */
+    bool solver::has_model(std::map<BasicTerm, expr_ref> const& var_name) const {
+        for (auto const& [var, e] : var_name) {
+            euf::enode* n = expr2enode(e);
+            bool has_value = false;
+            if (n)
+                for (euf::enode* s : euf::enode_class(n))
+                    has_value |= m_util_s.str.is_string(s->get_expr());
+            if (!has_value) {
+                TRACE("noodler", tout << "no value for " << mk_pp(e, m) << "\n";);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Collect the constraints of the current branch without duplicates. Arguments of memberships are
+     * replaced by their variables. @p constraints are the (negated) atoms of the collected constraints.
+     */
+    void solver::get_constraints(vector<expr_pair>& eqs, vector<expr_pair>& diseqs,
+                                 vector<expr_pair_flag>& memberships, expr_ref_vector& constraints) {
+        obj_hashtable<expr> seen;
+        auto add_constraint = [&](expr* c) {
+            if (seen.contains(c))
+                return false;
+            seen.insert(c);
+            constraints.push_back(c);
+            return true;
+        };
+        for (auto const& [a, b] : m_word_eqs)
+            if (a.get() != b.get() && add_constraint(mk_eq(a, b)))
+                eqs.push_back(expr_pair(a, b));
+        for (auto const& [a, b] : m_word_diseqs)
+            if (add_constraint(m.mk_not(mk_eq(a, b))))
+                diseqs.push_back(expr_pair(a, b));
+        for (auto const& [s, r, is_true] : m_memberships) {
+            expr_ref atom(m_util_s.re.mk_in_re(s, r), m);
+            if (!add_constraint(is_true ? atom.get() : m.mk_not(atom)))
+                continue;
+            expr* v = s;
+            m_term2var.find(s, v);
+            memberships.push_back(expr_pair_flag(expr_ref(v, m), r, is_true));
+        }
+    }
+
+    /**
+     * Collect basic terms of a concatenation @p e. Terms that are not variables, literals or concatenations
+     * are replaced by their variables.
+     */
+    void solver::collect_terms(expr* e, std::map<BasicTerm, expr_ref>& var_name, std::vector<BasicTerm>& terms) {
+        zstring str;
+        if (m_util_s.str.is_string(e, str)) {
+            terms.emplace_back(BasicTermType::Literal, str);
+            return;
+        }
+        if (m_util_s.str.is_empty(e)) {
+            terms.emplace_back(BasicTermType::Literal, zstring());
+            return;
+        }
+        if (m_util_s.str.is_concat(e)) {
+            for (expr* arg : *to_app(e))
+                collect_terms(arg, var_name, terms);
+            return;
+        }
+        expr* v = e;
+        m_term2var.find(e, v);
+        SASSERT(is_app(v) && to_app(v)->get_num_args() == 0);
+        BasicTerm var(BasicTermType::Variable, to_app(v)->get_decl()->get_name().str());
+        terms.push_back(var);
+        var_name.insert({ var, expr_ref(v, m) });
+    }
+
+    /**
+     * The instance is satisfiable, it is solved once its model can be built. The decision procedure does not
+     * produce words, so words of the variables are searched for among short words over @p alphabet (see
+     * smt::noodler::BoundedSearch, limited by str.bounded_timeout) and fixed by deciding the equalities of the
+     * variables with their words. The next final check sees the words in the classes of the variables. Words
+     * refuted by the other theories become disequations of the instance and are not tried again. The final
+     * check gives up only if no words are found.
+     */
+    sat::check_result solver::solve_with_model(vector<expr_pair> const& eqs, vector<expr_pair> const& diseqs,
+                                               vector<expr_pair_flag> const& memberships,
+                                               std::map<BasicTerm, expr_ref> const& var_name,
+                                               std::set<uint32_t> const& alphabet) {
+        if (has_model(var_name))
+            return sat::check_result::CR_DONE;
+        smt::noodler::BoundedSearch bounded(m, m_util_s, m_rewrite, &m_term2var);
+        for (auto const& [a, b] : eqs)
+            bounded.add_equation(a, b);
+        for (auto const& [a, b] : diseqs)
+            bounded.add_disequation(a, b);
+        for (auto const& [s, r, is_true] : memberships)
+            bounded.add_membership(s, r, is_true);
+        // the lengths of the words are checked by the arithmetic solver once the words are decided
+        auto any_lengths = [](ptr_vector<expr> const&, std::vector<zstring> const&) { return true; };
+        if (bounded.solve(alphabet, UINT_MAX, get_config().m_bounded_timeout, any_lengths) != l_true) {
+            ++m_stats.m_num_no_model;
+            return sat::check_result::CR_GIVEUP;
+        }
+        bool decided = false;
+        for (unsigned i = 0; i < bounded.get_vars().size(); ++i) {
+            expr* v = bounded.get_vars()[i];
+            expr_ref word(m_util_s.str.mk_string(bounded.get_word(i)), m);
+            sat::literal eq = eq_internalize(v, word);
+            if (s().value(eq) != l_undef)
+                continue;
+            TRACE("noodler", tout << "word " << mk_pp(v, m) << " = " << word << "\n";);
+            // the length of the word is known once the length of the variable is congruent to it
+            if (is_length_sensitive(v))
+                internalize(m_util_s.str.mk_length(word));
+            s().set_phase(eq);
+            decided = true;
+        }
+        if (!decided) {
+            ++m_stats.m_num_no_model;
+            return sat::check_result::CR_GIVEUP;
+        }
+        ++m_stats.m_num_model_words;
+        return sat::check_result::CR_CONTINUE;
+    }
+
+    sat::check_result solver::check() {
+        ++m_stats.m_num_final_checks;
+        if (m_num_unsupported > 0)
+            return sat::check_result::CR_GIVEUP;
+
+        vector<expr_pair> eqs, diseqs;
+        vector<expr_pair_flag> memberships;
+        expr_ref_vector constraints(m);
+        get_constraints(eqs, diseqs, memberships, constraints);
+        if (constraints.empty())
+            return sat::check_result::CR_DONE;
+
+        smt::noodler::Formula instance;
+        std::map<BasicTerm, expr_ref> var_name;
+        for (auto const& [a, b] : eqs) {
+            std::vector<BasicTerm> left, right;
+            collect_terms(a, var_name, left);
+            collect_terms(b, var_name, right);
+            instance.add_predicate(Predicate(PredicateType::Equation, std::vector<std::vector<BasicTerm>>{ left, right }));
+        }
+        for (auto const& [a, b] : diseqs) {
+            std::vector<BasicTerm> left, right;
+            collect_terms(a, var_name, left);
+            collect_terms(b, var_name, right);
+            instance.add_predicate(Predicate(PredicateType::Inequation, std::vector<std::vector<BasicTerm>>{ left, right }));
+        }
+        TRACE("noodler", for (auto const& p : instance.get_predicates()) tout << p.to_string() << "\n";);
+
+        size_t new_symbs = diseqs.size();
+        for (auto const& mem : memberships)
+            if (!std::get<2>(mem))
+                ++new_symbs;
+        std::set<uint32_t> symbols_in_formula{ smt::noodler::util::get_symbols_for_formula(eqs, diseqs, memberships, m_util_s, m) };
+        // words of the model use the symbols of the formula and one dummy symbol standing for the other characters
+        std::set<uint32_t> word_alphabet{ symbols_in_formula };
+        std::set<uint32_t> dummy_symbols{ smt::noodler::util::get_dummy_symbols(std::max(new_symbs, size_t(3)), symbols_in_formula) };
+        word_alphabet.insert(*dummy_symbols.begin());
+        smt::noodler::AutAssignment aut_assignment{ smt::noodler::util::create_aut_assignment_for_formula(
+            instance, memberships, var_name, m_util_s, m, symbols_in_formula) };
+
+        std::unordered_set<BasicTerm> length_vars;
+        std::vector<unsigned> key;
+        for (auto const& [var, e] : var_name) {
+            if (aut_assignment.find(var) != aut_assignment.end() && is_length_sensitive(e)) {
+                length_vars.insert(var);
+                key.push_back(e->get_id());
+            }
+        }
+
+        auto block = [&](expr* len_formula) {
+            sat::literal_vector lits;
+            for (expr* c : constraints)
+                lits.push_back(~mk_literal(c));
+            if (len_formula)
+                lits.push_back(mk_literal(len_formula));
+            add_clause(lits);
+        };
+
+        if (length_vars.empty()) {
+            smt::noodler::DecisionProcedure dec_proc{ instance, aut_assignment, length_vars, m, m_util_s, m_util_a, get_config() };
+            dec_proc.preprocess();
+            dec_proc.init_computation();
+            bool is_sat = dec_proc.compute_next_solution();
+            m_stats.m_num_noodles += dec_proc.get_num_noodles();
+            if (is_sat)
+                return solve_with_model(eqs, diseqs, memberships, var_name, word_alphabet);
+            ++m_stats.m_num_blocked;
+            block(nullptr);
+            return sat::check_result::CR_CONTINUE;
+        }
+
+        // The instance is satisfiable iff the lengths satisfy the length formula of one of its solutions.
+        // The formula of all solutions is computed once per instance and asserted as a lemma, the instance
+        // is solved as soon as the arithmetic solver satisfies it.
+        std::sort(key.begin(), key.end());
+        key.push_back(UINT_MAX);
+        for (expr* c : constraints)
+            key.push_back(c->get_id());
+        std::sort(key.end() - constraints.size(), key.end());
+
+        expr_ref len_formula(m);
+        auto it = m_len_lemmas.find(key);
+        if (it != m_len_lemmas.end())
+            len_formula = it->second;
+        else {
+            smt::noodler::DecisionProcedure dec_proc{ instance, aut_assignment, length_vars, m, m_util_s, m_util_a, get_config() };
+            dec_proc.preprocess();
+            dec_proc.init_computation();
+            expr_ref_vector solutions(m);
+            while (dec_proc.compute_next_solution())
+                solutions.push_back(dec_proc.get_lengths(var_name));
+            m_stats.m_num_noodles += dec_proc.get_num_noodles();
+            len_formula = ::mk_or(solutions);
+            m_pinned.append(constraints);
+            for (auto const& [var, e] : var_name)
+                m_pinned.push_back(e);
+            m_len_lemmas.emplace(key, len_formula);
+        }
+
+        if (is_true(mk_literal(len_formula)))
+            return solve_with_model(eqs, diseqs, memberships, var_name, word_alphabet);
+        ++m_stats.m_num_len_lemmas;
+        block(len_formula);
+        return sat::check_result::CR_CONTINUE;
+    }
+
+    /**
+     * Classes with a literal get the literal. Otherwise the value is the concatenation of the values
+     * of a concatenation in the class, or a word of the length of the class in the arithmetic model.
+     * Classes of variables of the instance always have a literal, see solve_with_model(). Classes without
+     * any of these get fresh values.
+     */
+    void solver::add_value(euf::enode* n, model& mdl, expr_ref_vector& values) {
+        expr* value = nullptr;
+        euf::enode* concat = nullptr;
+        for (euf::enode* s : euf::enode_class(n)) {
+            if (m_util_s.str.is_string(s->get_expr()))
+                value = s->get_expr();
+            else if (m_util_s.str.is_concat(s->get_expr()))
+                concat = s;
+        }
+        euf::enode* len = get_length(n);
+        rational len_val;
+        zstring str;
+        if (value)
+            mdl.register_value(value);
+        else if (concat) {
+            zstring word;
+            for (euf::enode* arg : euf::enode_args(concat)) {
+                VERIFY(m_util_s.str.is_string(values.get(arg->get_root_id()), str));
+                word = word + str;
+            }
+            value = m_util_s.str.mk_string(word);
+        }
+        else if (len && m_util_a.is_numeral(values.get(len->get_root_id()), len_val) && len_val.is_unsigned())
+            value = m_util_s.str.mk_string(zstring(std::string(len_val.get_unsigned(), 'a')));
+        else
+            value = mdl.get_fresh_value(n->get_sort());
+        values.set(n->get_root_id(), value);
+    }
+
+    bool solver::add_dep(euf::enode* n, top_sort<euf::enode>& dep) {
+        for (euf::enode* s : euf::enode_class(n)) {
+            if (m_util_s.str.is_string(s->get_expr())) {
+                dep.insert(n, nullptr);
+                return true;
+            }
+        }
+        for (euf::enode* s : euf::enode_class(n)) {
+            if (m_util_s.str.is_concat(s->get_expr())) {
+                for (euf::enode* arg : euf::enode_args(s))
+                    dep.add(n, arg->get_root());
+                return true;
+            }
+        }
+        if (euf::enode* len = get_length(n)) {
+            dep.add(n, len);
+            return true;
+        }
+        // other classes get fresh values, distinct from the values of the other classes
+        return false;
+    }
+
+    std::ostream& solver::display(std::ostream& out) const {
+        for (auto const& [a, b] : m_word_eqs)
+            out << mk_bounded_pp(a, m) << " = " << mk_bounded_pp(b, m) << "\n";
+        for (auto const& [a, b] : m_word_diseqs)
+            out << mk_bounded_pp(a, m) << " != " << mk_bounded_pp(b, m) << "\n";
+        for (auto const& [s, r, is_true] : m_memberships)
+            out << mk_bounded_pp(s, m) << (is_true ? " in " : " not in ") << mk_bounded_pp(r, m) << "\n";
+        if (m_num_unsupported > 0)
+            out << "unsupported terms: " << m_num_unsupported << "\n";
+        return out;
+    }
+
+    void solver::collect_statistics(statistics& st) const {
+        st.update("str final checks", m_stats.m_num_final_checks);
+        st.update("str noodles", m_stats.m_num_noodles);
+        st.update("str blocked assignments", m_stats.m_num_blocked);
+        st.update("str length lemmas", m_stats.m_num_len_lemmas);
+        st.update("str model words", m_stats.m_num_model_words);
+        st.update("str no model", m_stats.m_num_no_model);
+    }
+
+}
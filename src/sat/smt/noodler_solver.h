@@ -0,0 +1,118 @@
+/*++
+
+Module Name:
+
+    noodler_solver.h
+
+Abstract:
+
+    String theory plugin for the euf core driving the noodler decision procedure.
+
+    The plugin collects word equations, disequations and regular constraints from the
+    e-graph and hands them to smt::noodler::DecisionProcedure at final check. It handles
+    the core fragment of the noodler theory: string variables, literals, concatenation,
+    str.len and str.in_re. String terms outside of this fragment make the final check
+    give up.
+
+--*/
+#pragma once
+
+#include <map>
+#include "ast/arith_decl_plugin.h"
+#include "ast/seq_decl_plugin.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "sat/smt/sat_th.h"
+#include "smt/theory_str_noodler/formula.h"
+
+namespace euf {
+    class solver;
+}
+
+namespace noodler {
+
+    class solver : public euf::th_euf_solver {
+        typedef euf::theory_var theory_var;
+        typedef euf::theory_id theory_id;
+        typedef euf::enode enode;
+        typedef std::pair<expr_ref, expr_ref> expr_pair;
+        typedef std::tuple<expr_ref, expr_ref, bool> expr_pair_flag;
+
+        struct stats {
+            unsigned m_num_final_checks, m_num_noodles, m_num_blocked, m_num_len_lemmas, m_num_model_words, m_num_no_model;
+            void reset() { memset(this, 0, sizeof(stats)); }
+            stats() { reset(); }
+        };
+
+        seq_util                 m_util_s;
+        arith_util               m_util_a;
+        th_rewriter              m_rewrite;
+        stats                    m_stats;
+
+        // constraints of the current branch, collected from the e-graph and undone on backtracking
+        vector<expr_pair>        m_word_eqs;
+        vector<expr_pair>        m_word_diseqs;
+        vector<expr_pair_flag>   m_memberships;
+        // number of internalized string terms outside of the supported fragment
+        unsigned                 m_num_unsupported = 0;
+
+        // axioms of internalized terms, asserted in unit_propagate()
+        expr_ref_vector          m_axioms;
+        unsigned                 m_axioms_qhead = 0;
+
+        // string terms that are not variables, literals or concatenations (ite, uninterpreted
+        // functions, arguments of str.in_re) are represented by a fresh string variable
+        obj_map<expr, expr*>     m_term2var;
+        // length formulas of already solved instances, the key consists of the ids of the
+        // length sensitive variables and of the constraints of the instance
+        std::map<std::vector<unsigned>, expr_ref> m_len_lemmas;
+        expr_ref_vector          m_pinned;
+
+        bool visit(expr* e) override;
+        bool visited(expr* e) override;
+        bool post_visit(expr* e, bool sign, bool root) override;
+
+        void ensure_var(enode* n);
+        void ensure_term_var(expr* e);
+        void push_axiom(expr* e);
+        void add_length_axioms(expr* len);
+        bool is_supported(expr* e) const;
+        bool is_length_sensitive(expr* var) const;
+        euf::enode* get_length(euf::enode* n) const;
+        bool has_model(std::map<smt::noodler::BasicTerm, expr_ref> const& var_name) const;
+        sat::check_result solve_with_model(vector<expr_pair> const& eqs, vector<expr_pair> const& diseqs,
+                                           vector<expr_pair_flag> const& memberships,
+                                           std::map<smt::noodler::BasicTerm, expr_ref> const& var_name,
+                                           std::set<uint32_t> const& alphabet);
+        void collect_terms(expr* e, std::map<smt::noodler::BasicTerm, expr_ref>& var_name,
+                           std::vector<smt::noodler::BasicTerm>& terms);
+        void get_constraints(vector<expr_pair>& eqs, vector<expr_pair>& diseqs,
+                             vector<expr_pair_flag>& memberships, expr_ref_vector& constraints);
+
+    public:
+        solver(euf::solver& ctx, theory_id id);
+
+        void asserted(sat::literal l) override;
+        void new_eq_eh(euf::th_eq const& eq) override;
+        bool use_diseqs() const override { return true; }
+        void new_diseq_eh(euf::th_eq const& eq) override;
+
+        sat::literal internalize(expr* e, bool sign, bool root) override;
+        void internalize(expr* e) override;
+        void apply_sort_cnstr(euf::enode* n, sort* s) override;
+
+        bool unit_propagate() override;
+        void get_antecedents(sat::literal l, sat::ext_justification_idx idx, sat::literal_vector& r, bool probing) override { UNREACHABLE(); }
+        sat::check_result check() override;
+
+        std::ostream& display(std::ostream& out) const override;
+        std::ostream& display_justification(std::ostream& out, sat::ext_justification_idx idx) const override { UNREACHABLE(); return out; }
+        std::ostream& display_constraint(std::ostream& out, sat::ext_constraint_idx idx) const override { UNREACHABLE(); return out; }
+        void collect_statistics(statistics& st) const override;
+
+        void add_value(euf::enode* n, model& mdl, expr_ref_vector& values) override;
+        bool add_dep(euf::enode* n, top_sort<euf::enode>& dep) override;
+
+        euf::th_solver* clone(euf::solver& ctx) override { return alloc(solver, ctx, get_id()); }
+    };
+
+}
@@ -264,6 +264,7 @@ unsigned read_dimacs(char const * file_name) {
     else {
         r = g_solver->check();
     }
+    g_solver->save_clause_cache();
     switch (r) {
     case l_true: 
         std::cout << "s SATISFIABLE\n"; 
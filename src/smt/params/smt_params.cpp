@@ -48,6 +48,10 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_threads       = p.threads();
     m_threads_max_conflicts  = p.threads_max_conflicts();
     m_threads_cube_frequency = p.threads_cube_frequency();
+    m_threads_share_size = p.threads_share_size();
+    m_threads_share_lbd = p.threads_share_lbd();
+    m_threads_share_max = p.threads_share_max();
+    m_threads_cube_strings = p.threads_cube_strings();
     m_core_validate = p.core_validate();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
@@ -119,6 +123,10 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_threads);
     DISPLAY_PARAM(m_threads_max_conflicts);
     DISPLAY_PARAM(m_threads_cube_frequency);
+    DISPLAY_PARAM(m_threads_share_size);
+    DISPLAY_PARAM(m_threads_share_lbd);
+    DISPLAY_PARAM(m_threads_share_max);
+    DISPLAY_PARAM(m_threads_cube_strings);
     DISPLAY_PARAM(m_simplify_clauses);
     DISPLAY_PARAM(m_tick);
     DISPLAY_PARAM(m_display_features);
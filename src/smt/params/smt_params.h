@@ -107,6 +107,10 @@ struct smt_params : public preprocessor_params,
     unsigned         m_threads = 1;
     unsigned         m_threads_max_conflicts = UINT_MAX;
     unsigned         m_threads_cube_frequency = 2;
+    unsigned         m_threads_share_size = 8;
+    unsigned         m_threads_share_lbd = 4;
+    unsigned         m_threads_share_max = 1000;
+    bool             m_threads_cube_strings = false;
     bool             m_simplify_clauses = true;
     unsigned         m_tick = 1000;
     bool             m_display_features = false;
@@ -6,6 +6,9 @@ void theory_str_noodler_params::updt_params(params_ref const & _p) {
     smt_params_helper p(_p);
     m_underapproximation = p.str_underapprox();
     m_preprocess_red = p.str_preprocess_red();
+    m_bounded_len = p.str_bounded_len();
+    m_bounded_timeout = p.str_bounded_timeout();
+    m_event_log = p.str_event_log().str();
 }
 
 #define DISPLAY_PARAM(X) out << #X"=" << X << std::endl;
@@ -13,4 +16,7 @@ void theory_str_noodler_params::updt_params(params_ref const & _p) {
 void theory_str_noodler_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_underapproximation);
     DISPLAY_PARAM(m_preprocess_red);
+    DISPLAY_PARAM(m_bounded_len);
+    DISPLAY_PARAM(m_bounded_timeout);
+    DISPLAY_PARAM(m_event_log);
 }
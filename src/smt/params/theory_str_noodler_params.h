@@ -1,12 +1,19 @@
 
 #pragma once
 
+#include <string>
 #include "util/params.h"
 
 struct theory_str_noodler_params {
    
     bool m_underapproximation = false;
     bool m_preprocess_red = false;
+    // maximal word length of the bounded search before noodlification (0 = no bounded search)
+    unsigned m_bounded_len = 0;
+    // time budget of the bounded search in milliseconds
+    unsigned m_bounded_timeout = 100;
+    // file for the binary event log of the search (empty = no log)
+    std::string m_event_log;
 
     theory_str_noodler_params(params_ref const & p = params_ref()) {
         updt_params(p);
@@ -21,6 +21,7 @@ Author:
 #include "ast/expr_abstract.h"
 #include "ast/ast_util.h"
 #include "ast/for_each_expr.h"
+#include "ast/rewriter/var_subst.h"
 #include <ast/rewriter/expr_safe_replace.h>
 
 namespace smt {
@@ -30,7 +31,8 @@ namespace smt {
         ctx(th.get_context()),
         m(th.get_manager()),
         m_state_to_expr(m),
-        m_state_graph(state_graph::state_pp(this, pp_state)) { }
+        m_state_graph(state_graph::state_pp(this, pp_state)),
+        m_dfa(th.m_util.get_dfa_cache()) { }
 
     seq_util& seq_regex::u() { return th.m_util; }
     class seq_util::rex& seq_regex::re() { return th.m_util.re; }
@@ -217,12 +219,24 @@ namespace smt {
         }
 
         if (info.interpreted) {
+            lbool status = m_dfa.get_status(r);
+            if (status == l_false) {
+                STRACE("seq_regex_brief", tout << "(dead) ";);
+                th.add_axiom(~lit);
+                return true;
+            }
+            if (status == l_true)
+                return false;
             update_state_graph(r);            
-            if (m_state_graph.is_dead(get_state_id(r))) {
+            unsigned r_id = get_state_id(r);
+            if (m_state_graph.is_dead(r_id)) {
                 STRACE("seq_regex_brief", tout << "(dead) ";);
+                m_dfa.set_status(r, l_false);
                 th.add_axiom(~lit);
                 return true;
             }
+            if (m_state_graph.is_live(r_id))
+                m_dfa.set_status(r, l_true);
         }
         return false;
     }
@@ -521,8 +535,6 @@ namespace smt {
 
         literal null_lit = th.mk_literal(is_nullable);
         expr_ref hd = mk_first(r, n);
-        expr_ref d(m);
-        d = mk_derivative_wrapper(hd, r);
 
         literal_vector lits;
         lits.push_back(~lit);
@@ -530,7 +542,10 @@ namespace smt {
             lits.push_back(null_lit);
 
         expr_ref_pair_vector cofactors(m);
-        get_cofactors(d, cofactors);
+        if (!get_transitions(r, hd, cofactors)) {
+            expr_ref d = mk_derivative_wrapper(hd, r);
+            get_cofactors(d, cofactors);
+        }
         for (auto const& p : cofactors) {
             if (is_member(p.second, u)) 
                 continue;            
@@ -680,9 +695,9 @@ namespace smt {
         Note: this  implementation is inefficient: it simply collects all expressions under an if and 
         iterates over all combinations.
 
-        This method is still used by:
-            propagate_is_empty
-            propagate_is_non_empty
+        This method is still used by propagate_is_empty and
+        propagate_is_non_empty when the minterm transitions of
+        the regex are not available (see get_minterms).
     */
     void seq_regex::get_cofactors(expr* r, expr_ref_pair_vector& result) {
         obj_hashtable<expr> ifs;
@@ -723,6 +738,269 @@ namespace smt {
         }
     }
 
+    /*
+        Operations on sorted lists of disjoint character ranges
+    */
+    static void complement_ranges(unsigned max_c, svector<std::pair<unsigned, unsigned>>& ranges) {
+        svector<std::pair<unsigned, unsigned>> result;
+        unsigned next = 0;
+        for (auto const& r : ranges) {
+            if (r.first > next)
+                result.push_back(std::make_pair(next, r.first - 1));
+            if (r.second >= max_c) {
+                ranges.swap(result);
+                return;
+            }
+            next = r.second + 1;
+        }
+        result.push_back(std::make_pair(next, max_c));
+        ranges.swap(result);
+    }
+
+    static void intersect_ranges(svector<std::pair<unsigned, unsigned>> const& r1, svector<std::pair<unsigned, unsigned>>& ranges) {
+        svector<std::pair<unsigned, unsigned>> result;
+        unsigned i = 0, j = 0;
+        while (i < r1.size() && j < ranges.size()) {
+            unsigned lo = std::max(r1[i].first, ranges[j].first);
+            unsigned hi = std::min(r1[i].second, ranges[j].second);
+            if (lo <= hi)
+                result.push_back(std::make_pair(lo, hi));
+            if (r1[i].second < ranges[j].second)
+                ++i;
+            else
+                ++j;
+        }
+        ranges.swap(result);
+    }
+
+    static void union_ranges(svector<std::pair<unsigned, unsigned>> const& r1, svector<std::pair<unsigned, unsigned>>& ranges) {
+        ranges.append(r1);
+        std::sort(ranges.begin(), ranges.end());
+        unsigned j = 0;
+        for (unsigned i = 0; i < ranges.size(); ++i) {
+            if (j > 0 && ranges[i].first <= ranges[j - 1].second + 1)
+                ranges[j - 1].second = std::max(ranges[j - 1].second, ranges[i].second);
+            else
+                ranges[j++] = ranges[i];
+        }
+        ranges.shrink(j);
+    }
+
+    /*
+        Compute the characters satisfying the condition c over the character x
+        as a sorted list of disjoint ranges. Returns false if c is not a Boolean
+        combination of character range constraints on x.
+    */
+    bool seq_regex::get_char_ranges(expr* x, expr* c, char_ranges& ranges) {
+        unsigned max_c = u().max_char();
+        unsigned lo = 0, hi = 0;
+        bool negated = false;
+        expr* c1 = nullptr;
+        ranges.reset();
+        if (m.is_true(c)) {
+            ranges.push_back(std::make_pair(0u, max_c));
+            return true;
+        }
+        if (m.is_false(c))
+            return true;
+        if (u().is_char_const_range(x, c, lo, hi, negated)) {
+            hi = std::min(hi, max_c);
+            if (lo <= hi)
+                ranges.push_back(std::make_pair(lo, hi));
+            if (negated)
+                complement_ranges(max_c, ranges);
+            return true;
+        }
+        if (m.is_not(c, c1)) {
+            if (!get_char_ranges(x, c1, ranges))
+                return false;
+            complement_ranges(max_c, ranges);
+            return true;
+        }
+        if (m.is_and(c) || m.is_or(c)) {
+            bool is_and = m.is_and(c);
+            char_ranges r1;
+            if (is_and)
+                ranges.push_back(std::make_pair(0u, max_c));
+            for (expr* arg : *to_app(c)) {
+                if (!get_char_ranges(x, arg, r1))
+                    return false;
+                if (is_and)
+                    intersect_ranges(r1, ranges);
+                else
+                    union_ranges(r1, ranges);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /*
+        Return the target of a derivative expression d for the character ch,
+        by resolving the conditions of d whose ranges are given by cond2ranges.
+    */
+    expr_ref seq_regex::get_minterm_target(expr* d, unsigned ch, obj_map<expr, char_ranges> const& cond2ranges) {
+        expr* c = nullptr, * r1 = nullptr, * r2 = nullptr;
+        if (m.is_ite(d, c, r1, r2)) {
+            bool holds = false;
+            for (auto const& r : cond2ranges[c])
+                if (r.first <= ch && ch <= r.second) {
+                    holds = true;
+                    break;
+                }
+            return get_minterm_target(holds ? r1 : r2, ch, cond2ranges);
+        }
+        if (re().is_union(d, r1, r2)) {
+            expr_ref t1 = get_minterm_target(r1, ch, cond2ranges);
+            expr_ref t2 = get_minterm_target(r2, ch, cond2ranges);
+            return expr_ref(re().mk_union(t1, t2), m);
+        }
+        return expr_ref(d, m);
+    }
+
+    expr_ref seq_regex::mk_char_ranges(expr* x, char_ranges const& ranges) {
+        unsigned max_c = u().max_char();
+        expr_ref_vector disj(m);
+        for (auto const& r : ranges) {
+            if (r.first == r.second)
+                disj.push_back(m.mk_eq(x, u().mk_char(r.first)));
+            else if (r.first == 0 && r.second == max_c)
+                return expr_ref(m.mk_true(), m);
+            else if (r.first == 0)
+                disj.push_back(u().mk_le(x, u().mk_char(r.second)));
+            else if (r.second == max_c)
+                disj.push_back(u().mk_le(u().mk_char(r.first), x));
+            else
+                disj.push_back(m.mk_and(u().mk_le(u().mk_char(r.first), x), u().mk_le(x, u().mk_char(r.second))));
+        }
+        return mk_or(disj);
+    }
+
+    /*
+        Compute the minterm transitions of the regex r.
+
+        The ranges of the conditions in the derivative of r wrt (:var 0)
+        split the alphabet into intervals on which all conditions are constant.
+        The target for each interval is obtained by resolving the conditions,
+        intervals with the same target are merged into one transition and
+        empty targets are dropped. The number of transitions is thus linear
+        in the number of conditions, unlike the combinations enumerated by
+        get_cofactors.
+
+        Returns false if the derivative contains conditions that are not
+        character ranges or the elements are not characters.
+    */
+    bool seq_regex::get_minterms(expr* r, unsigned& begin, unsigned& end) {
+        if (m_dfa.find_transitions(r, begin, end))
+            return true;
+        if (m_dfa.is_unsupported(r))
+            return false;
+        auto fail = [&]() {
+            m_dfa.set_unsupported(r);
+            return false;
+        };
+        sort* seq_sort = nullptr, * ele_sort = nullptr;
+        VERIFY(u().is_re(r, seq_sort));
+        VERIFY(u().is_seq(seq_sort, ele_sort));
+        if (!u().is_char(ele_sort))
+            return fail();
+
+        unsigned max_c = u().max_char();
+        expr_ref d(seq_rw().mk_derivative(r), m);
+        expr_ref x(m.mk_var(0, ele_sort), m);
+
+        // collect the conditions of d and the boundaries of their ranges
+        obj_map<expr, char_ranges> cond2ranges;
+        unsigned_vector bounds;
+        bounds.push_back(0);
+        char_ranges ranges;
+        ptr_vector<expr> todo;
+        ast_mark visited;
+        expr* c = nullptr, * r1 = nullptr, * r2 = nullptr;
+        todo.push_back(d);
+        while (!todo.empty()) {
+            expr* e = todo.back();
+            todo.pop_back();
+            if (visited.is_marked(e))
+                continue;
+            visited.mark(e, true);
+            if (m.is_ite(e, c, r1, r2)) {
+                if (!cond2ranges.contains(c)) {
+                    if (!get_char_ranges(x, c, ranges))
+                        return fail();
+                    cond2ranges.insert(c, ranges);
+                    for (auto const& rg : ranges) {
+                        bounds.push_back(rg.first);
+                        if (rg.second < max_c)
+                            bounds.push_back(rg.second + 1);
+                    }
+                }
+                todo.push_back(r1);
+                todo.push_back(r2);
+            }
+            else if (re().is_union(e, r1, r2)) {
+                todo.push_back(r1);
+                todo.push_back(r2);
+            }
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.shrink(static_cast<unsigned>(std::unique(bounds.begin(), bounds.end()) - bounds.begin()));
+
+        // compute the target of each interval and group intervals by target
+        obj_map<expr, unsigned> target2class;
+        expr_ref_vector targets(m);
+        vector<char_ranges> classes;
+        for (unsigned i = 0; i < bounds.size(); ++i) {
+            unsigned lo = bounds[i];
+            unsigned hi = i + 1 < bounds.size() ? bounds[i + 1] - 1 : max_c;
+            expr_ref t = get_minterm_target(d, lo, cond2ranges);
+            rewrite(t);
+            if (re().is_empty(t))
+                continue;
+            unsigned idx = 0;
+            if (!target2class.find(t, idx)) {
+                idx = targets.size();
+                targets.push_back(t);
+                target2class.insert(t, idx);
+                classes.push_back(char_ranges());
+            }
+            char_ranges& cls = classes[idx];
+            if (!cls.empty() && cls.back().second + 1 == lo)
+                cls.back().second = hi;
+            else
+                cls.push_back(std::make_pair(lo, hi));
+        }
+
+        expr_ref_vector conds(m);
+        for (auto const& cls : classes)
+            conds.push_back(mk_char_ranges(x, cls));
+        m_dfa.set_transitions(r, conds, targets);
+        VERIFY(m_dfa.find_transitions(r, begin, end));
+        STRACE("seq_regex", tout << "minterms(" << mk_pp(r, m) << "): "
+                                 << cond2ranges.size() << " conditions, "
+                                 << targets.size() << " transitions" << std::endl;);
+        STRACE("seq_regex_brief", tout << "mt(" << state_str(r) << ")="
+                                       << targets.size() << " ";);
+        return true;
+    }
+
+    /*
+        Return the (condition, target) pairs of the minterm transitions of r
+        with the conditions instantiated for the head character hd.
+        Returns false if the minterms of r cannot be computed.
+    */
+    bool seq_regex::get_transitions(expr* r, expr* hd, expr_ref_pair_vector& result) {
+        unsigned begin = 0, end = 0;
+        if (!get_minterms(r, begin, end))
+            return false;
+        var_subst subst(m);
+        for (unsigned i = begin; i < end; ++i) {
+            expr_ref cond = subst(m_dfa.get_cond(i), hd);
+            result.push_back(cond, m_dfa.get_target(i));
+        }
+        return true;
+    }
+
     /*
       is_empty(r, u) => ~is_nullable(r)
       is_empty(r, u) => (forall x . ~cond(x)) or is_empty(r1, u union r)    for (cond, r) in min-terms(D(x,r))      
@@ -745,11 +1023,12 @@ namespace smt {
         }
         th.add_axiom(~lit, ~th.mk_literal(is_nullable));
         expr_ref hd = mk_first(r, n);
-        expr_ref d(m);
-        d = mk_derivative_wrapper(hd, r);
         literal_vector lits;
         expr_ref_pair_vector cofactors(m);
-        get_cofactors(d, cofactors);        
+        if (!get_transitions(r, hd, cofactors)) {
+            expr_ref d = mk_derivative_wrapper(hd, r);
+            get_cofactors(d, cofactors);
+        }
         for (auto const& p : cofactors) {
             if (is_member(p.second, u))
                 continue;
@@ -839,13 +1118,20 @@ namespace smt {
         expr_ref r_nullable = is_nullable_wrapper(r);
         if (m.is_true(r_nullable)) {
             m_state_graph.mark_live(r_id);
+            m_dfa.set_status(r, l_true);
         }
         else {
             // Add edges to all derivatives
             expr_ref_vector derivatives(m);
             STRACE("seq_regex_verbose", tout
                 << "getting all derivs: " << r_id << " " << std::endl;);
-            get_derivative_targets(r, derivatives);
+            unsigned begin = 0, end = 0;
+            if (get_minterms(r, begin, end)) {
+                for (unsigned i = begin; i < end; ++i)
+                    derivatives.push_back(m_dfa.get_target(i));
+            }
+            else
+                get_derivative_targets(r, derivatives);
             for (auto const& dr: derivatives) {
                 unsigned dr_id = get_state_id(dr);
                 STRACE("seq_regex_verbose", tout
@@ -854,7 +1140,16 @@ namespace smt {
                     if (!m_state_graph.is_seen(dr_id))
                         tout << "state(" << dr_id << ") = " << re().to_str(dr) << std::endl << "info(" << dr_id << ") = " << re().get_info(dr) << std::endl;);
                 // Add state
+                bool is_new = !m_state_graph.is_seen(dr_id);
                 m_state_graph.add_state(dr_id);
+                // Reuse verdicts from earlier explorations over the same manager
+                if (is_new && dr_id != r_id) {
+                    lbool status = m_dfa.get_status(dr);
+                    if (status == l_true)
+                        m_state_graph.mark_live(dr_id);
+                    else if (status == l_false)
+                        m_state_graph.mark_done(dr_id);
+                }
                 bool maybecycle = can_be_in_cycle(r, dr);
                 m_state_graph.add_edge(r_id, dr_id, maybecycle);
             }
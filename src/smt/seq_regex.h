@@ -126,6 +126,23 @@ namespace smt {
         // Update the graph
         bool update_state_graph(expr* r);
 
+        /*
+            Minterm transitions of regex states.
+            The character conditions in the derivative of a state wrt (:var 0)
+            partition the alphabet into classes of characters that lead to the
+            same target. The transitions of a state are computed once, stored as
+            (class condition over (:var 0), target) pairs in the automata cache
+            of the manager (together with dead and live verdicts of states) and
+            instantiated with the actual head character when unfolding.
+        */
+        typedef svector<std::pair<unsigned, unsigned>> char_ranges;
+        seq_dfa_cache&                 m_dfa;
+        bool get_char_ranges(expr* x, expr* c, char_ranges& ranges);
+        expr_ref get_minterm_target(expr* d, unsigned ch, obj_map<expr, char_ranges> const& cond2ranges);
+        expr_ref mk_char_ranges(expr* x, char_ranges const& ranges);
+        bool get_minterms(expr* r, unsigned& begin, unsigned& end);
+        bool get_transitions(expr* r, expr* hd, expr_ref_pair_vector& result);
+
         // Printing expressions for seq_regex_brief
         std::string state_str(expr* e);
         std::string expr_id_str(expr* e);
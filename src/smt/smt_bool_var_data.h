@@ -31,6 +31,7 @@ namespace smt {
         unsigned                m_assumption:1;
         unsigned                m_phase_available:1;
         unsigned                m_phase:1;
+        unsigned                m_string_atom:1;  //!< string atom, set at internalization when cubing on strings (see lookahead::is_string_atom)
     private:
         unsigned                m_eq:1;
         unsigned                m_true_first:1;   //!< If True, when case splitting try the true phase first. Otherwise, you default phase selection heuristic.
@@ -122,6 +123,7 @@ namespace smt {
             m_assumption      = false;
             m_phase_available = false;
             m_phase           = false;
+            m_string_atom     = false;
             m_iscope_lvl      = iscope_lvl;
             m_eq              = false;
             m_true_first      = false;
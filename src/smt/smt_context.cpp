@@ -4058,6 +4058,28 @@ namespace smt {
     }
 
 
+    void context::export_lemma(unsigned num_lits, literal const * lits) {
+        // units are exchanged through the assignment at the base level
+        if (num_lits < 2 || num_lits > m_fparams.m_threads_share_size ||
+            m_lemma_outbox->size() >= m_fparams.m_threads_share_max)
+            return;
+        m_lemma_outbox_lvls.reset();
+        for (unsigned i = 0; i < num_lits; ++i) {
+            // unassigned literals (possible in theory lemmas) count as one extra level
+            m_lemma_outbox_lvls.push_back(get_assignment(lits[i]) == l_undef ? UINT_MAX : get_assign_level(lits[i]));
+        }
+        std::sort(m_lemma_outbox_lvls.begin(), m_lemma_outbox_lvls.end());
+        unsigned lbd = static_cast<unsigned>(std::unique(m_lemma_outbox_lvls.begin(), m_lemma_outbox_lvls.end()) - m_lemma_outbox_lvls.begin());
+        if (lbd > m_fparams.m_threads_share_lbd)
+            return;
+        expr_ref_vector cls(m);
+        for (unsigned i = 0; i < num_lits; ++i) {
+            expr* e = bool_var2expr(lits[i].var());
+            cls.push_back(lits[i].sign() ? m.mk_not(e) : e);
+        }
+        m_lemma_outbox->push_back(cls);
+    }
+
     bool context::resolve_conflict() {
         m_stats.m_num_conflicts++;
         m_num_conflicts ++;
@@ -4106,6 +4128,10 @@ namespace smt {
                 new_lvl = conflict_lvl - 1;
             }
 
+            // export before backtracking, the levels of the literals are needed for the LBD
+            if (m_lemma_outbox)
+                export_lemma(num_lits, lits);
+
             // Some of the literals/enodes of the conflict clause will be destroyed during
             // backtracking, and will need to be recreated. However, I want to keep
             // the generation number for enodes that are going to be recreated. See
@@ -177,6 +177,8 @@ namespace smt {
         vector<clause_vector>       m_clauses_to_reinit;
         expr_ref_vector             m_units_to_reassert;
         svector<char>               m_units_to_reassert_sign;
+        vector<expr_ref_vector>*    m_lemma_outbox = nullptr; //!< short lemmas exported for other contexts (see smt::parallel)
+        unsigned_vector             m_lemma_outbox_lvls;
         literal_vector              m_assigned_literals;
         typedef std::pair<clause*, literal_vector> tmp_clause;
         vector<tmp_clause>          m_tmp_clauses;
@@ -329,6 +331,13 @@ namespace smt {
 
         clause_vector const& get_lemmas() const { return m_lemmas; }
 
+        /**
+           \brief Export learned clauses and theory lemmas with at most m_threads_share_size literals and
+           LBD at most m_threads_share_lbd into \c outbox (nullptr stops the export). The clauses are
+           stored as vectors of literal expressions, the owner of the outbox is responsible for emptying it.
+        */
+        void set_lemma_outbox(vector<expr_ref_vector>* outbox) { m_lemma_outbox = outbox; }
+
         literal get_literal(expr * n) const;
 
         bool has_enode(bool_var v) const {
@@ -1251,6 +1260,8 @@ namespace smt {
 
         virtual bool resolve_conflict();
 
+        void export_lemma(unsigned num_lits, literal const * lits);
+
 
         // -----------------------------------
         //
@@ -22,6 +22,7 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_smt2_pp.h"
 #include "smt/smt_model_finder.h"
+#include "smt/smt_lookahead.h"
 #include "ast/for_each_expr.h"
 
 #include <iostream>
@@ -945,6 +946,8 @@ namespace smt {
         bool_var_data & data = m_bdata[v];
         unsigned iscope_lvl = m_scope_lvl; // record when the boolean variable was internalized.
         data.init(iscope_lvl); 
+        if (m_fparams.m_threads_cube_strings)
+            data.m_string_atom = lookahead::is_string_atom(m, n);
         if (m_fparams.m_random_initial_activity == IA_RANDOM || (m_fparams.m_random_initial_activity == IA_RANDOM_WHEN_SEARCHING && m_searching))
             m_activity[v]      = -((m_random() % 1000) / 1000.0); 
         else
@@ -1377,6 +1380,10 @@ namespace smt {
     clause * context::mk_clause(unsigned num_lits, literal * lits, justification * j, clause_kind k, clause_del_eh * del_eh) {
         TRACE("mk_clause", display_literals_verbose(tout << "creating clause: " << literal_vector(num_lits, lits) << "\n", num_lits, lits) << "\n";);
         m_clause_proof.add(num_lits, lits, k, j);
+        // theories add their lemmas and axioms through mk_th_clause or directly (e.g. arithmetic bound propagation),
+        // the axioms of the input terms are created by every context and are not exported
+        if (m_lemma_outbox && m_searching && (k == CLS_TH_LEMMA || k == CLS_TH_AXIOM))
+            export_lemma(num_lits, lits);
         switch (k) {
         case CLS_TH_AXIOM:
             dump_axiom(num_lits, lits);
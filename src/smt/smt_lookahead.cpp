@@ -20,13 +20,82 @@ Revision History:
 #include <cmath>
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
+#include "ast/for_each_expr.h"
 #include "smt/smt_lookahead.h"
 #include "smt/smt_context.h"
 
 namespace smt {
 
-    lookahead::lookahead(context& ctx): 
-        ctx(ctx), m(ctx.get_manager()) {}
+    lookahead::lookahead(context& ctx, bool strings): 
+        ctx(ctx), m(ctx.get_manager()), m_strings(strings), m_seq(m), m_arith(m) {}
+
+    /**
+       \brief Number of length terms in the arithmetic term or atom e.
+       Only arithmetic terms (and if-then-else terms) are traversed.
+    */
+    unsigned lookahead::num_length_terms(seq_util const& seq, arith_util const& arith, expr* e) {
+        ast_manager& m = seq.get_manager();
+        unsigned n = 0;
+        ptr_buffer<expr> todo;
+        todo.push_back(e);
+        while (!todo.empty()) {
+            e = todo.back();
+            todo.pop_back();
+            if (seq.str.is_length(e))
+                ++n;
+            else if (is_app(e) && (arith.is_arith_expr(e) || arith.is_le(e) || arith.is_ge(e) || arith.is_lt(e) || arith.is_gt(e) || m.is_eq(e) || m.is_ite(e)))
+                todo.append(to_app(e)->get_num_args(), to_app(e)->get_args());
+        }
+        return n;
+    }
+
+    /**
+       \brief String atoms are regular memberships, word equations and
+       arithmetic atoms over lengths of strings. The context computes this once
+       per atom when it is internalized (bool_var_data::m_string_atom).
+    */
+    bool lookahead::is_string_atom(ast_manager& m, expr* e) {
+        seq_util seq(m);
+        arith_util arith(m);
+        expr* x = nullptr, * y = nullptr;
+        if (seq.str.is_in_re(e))
+            return true;
+        if (m.is_eq(e, x, y) && seq.is_string(x->get_sort()))
+            return true;
+        if (!arith.is_le(e) && !arith.is_ge(e) && !arith.is_lt(e) && !arith.is_gt(e) && !(m.is_eq(e, x, y) && arith.is_int_real(x)))
+            return false;
+        return num_length_terms(seq, arith, e) > 0;
+    }
+
+    /**
+       \brief Estimate the cost the string atom adds to the string solver: the
+       size of the regular expression for memberships (the automaton built from
+       it grows with it), the product of the numbers of terms of both sides for
+       word equations (bounds the number of noodles of the equation) and the
+       number of length terms for length constraints.
+    */
+    double lookahead::get_string_weight(expr* e) const {
+        expr* x = nullptr, * y = nullptr;
+        auto num_terms = [&](expr* t) {
+            unsigned n = 0;
+            ptr_buffer<expr> todo;
+            todo.push_back(t);
+            while (!todo.empty()) {
+                t = todo.back();
+                todo.pop_back();
+                if (m_seq.str.is_concat(t))
+                    todo.append(to_app(t)->get_num_args(), to_app(t)->get_args());
+                else
+                    ++n;
+            }
+            return n;
+        };
+        if (m_seq.str.is_in_re(e, x, y))
+            return get_num_exprs(y);
+        if (m.is_eq(e, x, y) && m_seq.is_string(x->get_sort()))
+            return num_terms(x) * num_terms(y);
+        return num_length_terms(m_seq, m_arith, e);
+    }
 
     double lookahead::get_score() {
         double score = 0;
@@ -72,10 +141,14 @@ namespace smt {
         svector<bool_var> vars;
         for (bool_var v = 0; v < static_cast<bool_var>(sz); ++v) {
             expr* b = ctx.bool_var2expr(v);
-            if (b && ctx.get_assignment(v) == l_undef) {
+            if (b && ctx.get_assignment(v) == l_undef && (!m_strings || ctx.get_bdata(v).m_string_atom)) {
                 vars.push_back(v);
             }
         }
+        if (m_strings && vars.empty()) {
+            // no open string atoms, fall back to all atoms
+            return lookahead(ctx).choose(budget);
+        }
         compare comp(ctx);
         std::sort(vars.begin(), vars.end(), comp);
         
@@ -118,6 +191,8 @@ namespace smt {
                 continue;
             }
             double score = score1 + score2 + 1024*score1*score2;
+            if (m_strings) 
+                score = (score + 1) * get_string_weight(ctx.bool_var2expr(v));
 
             if (score <= 1.1*best_score && best_score <= 1.1*score) {
                 if (ctx.get_random_value() % (++n) == 0) {
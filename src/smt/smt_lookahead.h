@@ -20,6 +20,8 @@ Revision History:
 #pragma once
 
 #include "ast/ast.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/seq_decl_plugin.h"
 
 namespace smt {
     class context;
@@ -27,15 +29,24 @@ namespace smt {
     class lookahead {
         context&     ctx;
         ast_manager& m;
+        // restrict the candidates to string atoms (see threads.cube_strings)
+        bool         m_strings;
+        seq_util     m_seq;
+        arith_util   m_arith;
 
         struct compare;
 
         double get_score();
 
+        static unsigned num_length_terms(seq_util const& seq, arith_util const& arith, expr* e);
+        double get_string_weight(expr* e) const;
+
         void choose_rec(expr_ref_vector& trail, expr_ref_vector& result, unsigned depth, unsigned budget);
 
     public:
-        lookahead(context& ctx);
+        lookahead(context& ctx, bool strings = false);
+
+        static bool is_string_atom(ast_manager& m, expr* e);
 
         expr_ref choose(unsigned budget = 2000);
 
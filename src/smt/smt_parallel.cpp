@@ -17,10 +17,12 @@ Author:
 
 
 #include "util/scoped_ptr_vector.h"
+#include "util/thread_pool.h"
 #include "ast/ast_util.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_translation.h"
+#include "ast/seq_decl_plugin.h"
 #include "smt/smt_parallel.h"
 #include "smt/smt_lookahead.h"
 
@@ -38,6 +40,37 @@ namespace smt {
 #include <thread>
 
 namespace smt {
+
+    namespace {
+        /**
+           \brief Units and lemmas containing skolem terms of the string solvers (fresh variables and
+           seq skolems) are local to the context that created them. The name of a skolem is only unique
+           within its manager, another thread may use the same name for a different term, so such clauses
+           are not exchanged. Contexts without a string theory do not create these terms and are not
+           searched.
+        */
+        bool is_shareable(context& ctx, expr* e) {
+            ast_manager& m = ctx.get_manager();
+            family_id seq_fid = m.get_family_id("seq");
+            if (!ctx.get_theory(seq_fid))
+                return true;
+            ptr_buffer<expr> todo;
+            expr_fast_mark1 visited;
+            todo.push_back(e);
+            while (!todo.empty()) {
+                expr* t = todo.back();
+                todo.pop_back();
+                if (!is_app(t) || visited.is_marked(t))
+                    continue;
+                visited.mark(t);
+                func_decl* d = to_app(t)->get_decl();
+                if (d->is_skolem() || is_decl_of(d, seq_fid, _OP_SEQ_SKOLEM))
+                    return false;
+                todo.append(to_app(t)->get_num_args(), to_app(t)->get_args());
+            }
+            return true;
+        }
+    }
     
     lbool parallel::operator()(expr_ref_vector const& asms) {
 
@@ -80,6 +113,10 @@ namespace smt {
         for (unsigned i = 0; i < num_threads; ++i) {
             smt_params.push_back(ctx.get_fparams());
         }
+        // short lemmas learned by each thread in the current round; every thread writes only to its own outbox
+        // and the outboxes are emptied by collect_lemmas while the threads are joined, so no locking is needed
+        vector<vector<expr_ref_vector>> outboxes(num_threads);
+        bool share_lemmas = ctx.get_fparams().m_threads_share_size > 1 && ctx.get_fparams().m_threads_share_max > 0;
         for (unsigned i = 0; i < num_threads; ++i) {
             ast_manager* new_m = alloc(ast_manager, m, true);
             pms.push_back(new_m);
@@ -87,13 +124,15 @@ namespace smt {
             context& new_ctx = *pctxs.back();
             context::copy(ctx, new_ctx, true);
             new_ctx.set_random_seed(i + ctx.get_fparams().m_random_seed);
+            if (share_lemmas)
+                new_ctx.set_lemma_outbox(&outboxes[i]);
             ast_translation tr(m, *new_m);
             pasms.push_back(tr(asms));
             sl.push_child(&(new_m->limit()));
         }
 
         auto cube = [](context& ctx, expr_ref_vector& lasms, expr_ref& c) {
-            lookahead lh(ctx);
+            lookahead lh(ctx, ctx.get_fparams().m_threads_cube_strings);
             c = lh.choose();
             if (c) {
                 if ((ctx.get_random_value() % 2) == 0) 
@@ -107,6 +146,59 @@ namespace smt {
         unsigned_vector unit_lim;
         for (unsigned i = 0; i < num_threads; ++i) unit_lim.push_back(0);
 
+        unsigned num_local_units = 0;
+
+        // lemmas shared so far (as disjunctions over sorted literals in ctx.m), the thread they come from
+        // and how many of them were already sent to each thread
+        obj_hashtable<expr> lemma_set;
+        expr_ref_vector lemma_trail(ctx.m);
+        unsigned_vector lemma_src;
+        unsigned_vector lemma_lim(num_threads, 0u);
+        unsigned num_local_lemmas = 0;
+
+        auto collect_lemmas = [&]() {
+            for (unsigned i = 0; i < num_threads; ++i) {
+                context& pctx = *pctxs[i];
+                // one translation per thread and round, subterms shared by the lemmas are translated once
+                ast_translation tr(pctx.m, ctx.m);
+                for (expr_ref_vector const& cls : outboxes[i]) {
+                    expr_ref_vector lits(ctx.m);
+                    bool ok = true;
+                    for (expr* lit : cls) {
+                        if (!is_shareable(pctx, lit)) {
+                            ok = false;
+                            break;
+                        }
+                        lits.push_back(tr(lit));
+                    }
+                    if (!ok) {
+                        ++num_local_lemmas;
+                        continue;
+                    }
+                    std::sort(lits.data(), lits.data() + lits.size(), [](expr* a, expr* b) { return a->get_id() < b->get_id(); });
+                    expr_ref lemma(ctx.m.mk_or(lits), ctx.m);
+                    if (!lemma_set.contains(lemma)) {
+                        lemma_set.insert(lemma);
+                        lemma_trail.push_back(lemma);
+                        lemma_src.push_back(i);
+                    }
+                }
+                outboxes[i].reset();
+            }
+
+            unsigned sz = lemma_trail.size();
+            for (unsigned i = 0; i < num_threads; ++i) {
+                context& pctx = *pctxs[i];
+                ast_translation tr(ctx.m, pctx.m);
+                for (unsigned j = lemma_lim[i]; j < sz; ++j) {
+                    if (lemma_src[j] != i)
+                        pctx.assert_expr(tr(lemma_trail.get(j)));
+                }
+                lemma_lim[i] = sz;
+            }
+            IF_VERBOSE(1, verbose_stream() << "(smt.thread :lemmas " << sz << " :local-lemmas " << num_local_lemmas << ")\n");
+        };
+
         std::function<void(void)> collect_units = [&,this]() {
             for (unsigned i = 0; i < num_threads; ++i) {
                 context& pctx = *pctxs[i];
@@ -116,6 +208,10 @@ namespace smt {
                 for (unsigned j = unit_lim[i]; j < sz; ++j) {
                     literal lit = pctx.assigned_literals()[j];
                     expr_ref e(pctx.bool_var2expr(lit.var()), pctx.m);
+                    if (!is_shareable(pctx, e)) {
+                        ++num_local_units;
+                        continue;
+                    }
                     if (lit.sign()) e = pctx.m.mk_not(e);
                     expr_ref ce(tr(e.get()), ctx.m);
                     if (!unit_set.contains(ce)) {
@@ -136,7 +232,7 @@ namespace smt {
                 }
                 unit_lim[i] = sz;
             }
-            IF_VERBOSE(1, verbose_stream() << "(smt.thread :units " << sz << ")\n");
+            IF_VERBOSE(1, verbose_stream() << "(smt.thread :units " << sz << " :local-units " << num_local_units << ")\n");
         };
 
         std::mutex mux;
@@ -215,24 +311,22 @@ namespace smt {
         // for debugging:  num_threads = 1;
 
         while (true) {
-            vector<std::thread> threads(num_threads);
-            for (unsigned i = 0; i < num_threads; ++i) {
-                threads[i] = std::thread([&, i]() { worker_thread(i); });
-            }
-            for (auto & th : threads) {
-                th.join();
-            }
+            thread_pool::run(num_threads, [&](unsigned i) { worker_thread(i); }, &m.limit());
             if (done) break;
 
             collect_units();
+            if (share_lemmas)
+                collect_lemmas();
             ++num_rounds;
             max_conflicts = (max_conflicts < thread_max_conflicts) ? 0 : (max_conflicts - thread_max_conflicts);
             thread_max_conflicts *= 2;            
         }
 
         for (context* c : pctxs) {
+            c->set_lemma_outbox(nullptr);
             c->collect_statistics(ctx.m_aux_stats);
         }
+        ctx.m_aux_stats.update("parallel shared lemmas", lemma_trail.size());
 
         if (finished_id == UINT_MAX) {
             switch (ex_kind) {
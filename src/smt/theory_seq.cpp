@@ -1905,6 +1905,8 @@ void theory_seq::collect_statistics(::statistics & st) const {
     st.update("seq fixed length", m_stats.m_fixed_length);
     st.update("seq int.to.str", m_stats.m_int_string);
     st.update("seq str.from_ubv", m_stats.m_ubv_string);
+    m_util.get_op_cache().collect_statistics(st);
+    m_util.get_dfa_cache().collect_statistics(st);
 }
 
 void theory_seq::init_search_eh() {
@@ -0,0 +1,257 @@
+#include <algorithm>
+
+#include "bounded_search.h"
+#include "util.h"
+
+namespace smt::noodler {
+
+    BoundedSearch::BoundedSearch(ast_manager& m, seq_util& m_util_s, th_rewriter& rewrite,
+                                 const obj_map<expr, expr*>* term2var)
+        : m(m), m_util_s(m_util_s), m_rewrite(rewrite), term2var(term2var) { }
+
+    /**
+     * @brief Flatten concatenations of @p e into the side @p s, replacing terms by their variables.
+     */
+    void BoundedSearch::flatten(expr* e, side& s) {
+        expr* a = nullptr, * b = nullptr, * v = nullptr;
+        if(m_util_s.str.is_concat(e, a, b)) {
+            flatten(a, s);
+            flatten(b, s);
+        } else if(m_util_s.str.is_empty(e)) {
+            return;
+        } else if(term2var != nullptr && term2var->find(e, v)) {
+            s.push_back(v);
+        } else {
+            s.push_back(e);
+        }
+    }
+
+    void BoundedSearch::add_vars(const side& s) {
+        for(expr* t : s) {
+            if(util::is_str_variable(t, m_util_s)) {
+                var_set.insert(t);
+            } else if(!m_util_s.str.is_string(t)) {
+                supported = false;
+            }
+        }
+    }
+
+    void BoundedSearch::add_equation(expr* left, expr* right) {
+        eqs.emplace_back();
+        flatten(left, eqs.back().first);
+        flatten(right, eqs.back().second);
+        add_vars(eqs.back().first);
+        add_vars(eqs.back().second);
+    }
+
+    void BoundedSearch::add_disequation(expr* left, expr* right) {
+        diseqs.emplace_back();
+        flatten(left, diseqs.back().first);
+        flatten(right, diseqs.back().second);
+        add_vars(diseqs.back().first);
+        add_vars(diseqs.back().second);
+    }
+
+    void BoundedSearch::add_membership(expr* str, expr* re, bool is_true) {
+        memb_sides.emplace_back();
+        flatten(str, memb_sides.back());
+        add_vars(memb_sides.back());
+        memb_langs.emplace_back(expr_ref(re, m), is_true);
+    }
+
+    void BoundedSearch::assign(unsigned i, const zstring& w) {
+        value[i] = w;
+        assigned[i] = true;
+        trail.push_back(i);
+    }
+
+    void BoundedSearch::undo(unsigned sz) {
+        while(trail.size() > sz) {
+            assigned[trail.back()] = false;
+            trail.pop_back();
+        }
+    }
+
+    /**
+     * @brief Value of a flattened side, false if it contains an unassigned variable.
+     */
+    bool BoundedSearch::eval(const side& s, zstring& w) const {
+        zstring lit;
+        unsigned i = 0;
+        w = zstring();
+        for(expr* t : s) {
+            if(m_util_s.str.is_string(t, lit)) {
+                w = w + lit;
+            } else if(var2idx.find(t, i) && assigned[i]) {
+                w = w + value[i];
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool BoundedSearch::check_memb(unsigned i, const zstring& w) {
+        std::string key = w.encode();
+        auto it = memb_cache[i].find(key);
+        if(it != memb_cache[i].end()) {
+            return it->second;
+        }
+        expr_ref in_re(m_util_s.re.mk_in_re(m_util_s.str.mk_string(w), memb_langs[i].first), m);
+        m_rewrite(in_re);
+        // memberships the rewriter does not decide are treated as violated
+        bool res = memb_langs[i].second ? m.is_true(in_re) : m.is_false(in_re);
+        memb_cache[i][key] = res;
+        return res;
+    }
+
+    /**
+     * @brief Solve equations with a single unassigned variable occurring once and check the constraints
+     *  whose variables are assigned.
+     *
+     * @return false if a constraint is violated
+     */
+    bool BoundedSearch::propagate() {
+        bool change = true;
+        zstring w1, w2;
+        while(change) {
+            change = false;
+            for(const auto& eq : eqs) {
+                if(eval(eq.first, w1) && eval(eq.second, w2)) {
+                    if(w1 != w2) {
+                        return false;
+                    }
+                    continue;
+                }
+                // find the only unassigned variable of the equation
+                const side* var_side = nullptr;
+                unsigned pos = 0, num = 0;
+                for(const side* s : { &eq.first, &eq.second }) {
+                    for(unsigned j = 0; j < s->size(); ++j) {
+                        expr* t = (*s)[j];
+                        if(is_var(t) && !assigned[var2idx[t]]) {
+                            ++num;
+                            var_side = s;
+                            pos = j;
+                        }
+                    }
+                }
+                if(num != 1) {
+                    continue;
+                }
+                const side& other = var_side == &eq.first ? eq.second : eq.first;
+                zstring pref, suf, w;
+                VERIFY(eval(other, w));
+                VERIFY(eval(side(var_side->begin(), var_side->begin() + pos), pref));
+                VERIFY(eval(side(var_side->begin() + pos + 1, var_side->end()), suf));
+                if(pref.length() + suf.length() > w.length() || !pref.prefixof(w) || !suf.suffixof(w)) {
+                    return false;
+                }
+                assign(var2idx[(*var_side)[pos]], w.extract(pref.length(), w.length() - pref.length() - suf.length()));
+                change = true;
+            }
+        }
+        for(const auto& diseq : diseqs) {
+            if(eval(diseq.first, w1) && eval(diseq.second, w2) && w1 == w2) {
+                return false;
+            }
+        }
+        for(unsigned i = 0; i < memb_sides.size(); ++i) {
+            if(eval(memb_sides[i], w1) && !check_memb(i, w1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool BoundedSearch::out_of_budget() {
+        timeout = timeout || !m.inc() || sw.get_current_seconds() * 1000 > timeout_ms;
+        return timeout;
+    }
+
+    bool BoundedSearch::search(unsigned k, const LengthCheck& check_lengths) {
+        unsigned sz = trail.size();
+        if(out_of_budget() || !propagate()) {
+            undo(sz);
+            return false;
+        }
+        unsigned i = 0;
+        while(i < vars.size() && assigned[i]) {
+            ++i;
+        }
+        if(i == vars.size()) {
+            if(check_lengths(vars, value)) {
+                return true;
+            }
+            undo(sz);
+            return false;
+        }
+        bound_reached = true;
+        // enumerate the words of length at most k
+        for(unsigned len = 0; len <= k; ++len) {
+            std::vector<unsigned> word(len, 0);
+            while(true) {
+                zstring w;
+                for(unsigned c : word) {
+                    w = w + zstring(symbols[c]);
+                }
+                unsigned sz1 = trail.size();
+                assign(i, w);
+                if(search(k, check_lengths)) {
+                    return true;
+                }
+                undo(sz1);
+                if(timeout) {
+                    undo(sz);
+                    return false;
+                }
+                // next word of the same length
+                unsigned j = 0;
+                while(j < len && ++word[j] == symbols.size()) {
+                    word[j++] = 0;
+                }
+                if(j == len) {
+                    break;
+                }
+            }
+        }
+        undo(sz);
+        return false;
+    }
+
+    lbool BoundedSearch::solve(const std::set<uint32_t>& alphabet, unsigned max_len, unsigned time_budget,
+                               const LengthCheck& check_lengths) {
+        if(!supported || alphabet.empty()) {
+            return l_undef;
+        }
+        vars.reset();
+        var2idx.reset();
+        for(expr* v : var_set) {
+            vars.push_back(v);
+        }
+        std::sort(vars.begin(), vars.end(), [](expr* a, expr* b) { return a->get_id() < b->get_id(); });
+        for(unsigned i = 0; i < vars.size(); ++i) {
+            var2idx.insert(vars[i], i);
+        }
+        value.assign(vars.size(), zstring());
+        assigned.assign(vars.size(), false);
+        trail.reset();
+        memb_cache.assign(memb_sides.size(), {});
+        symbols.assign(alphabet.begin(), alphabet.end());
+
+        timeout_ms = time_budget;
+        timeout = false;
+        sw.reset();
+        sw.start();
+        for(unsigned k = 0; k <= max_len && !timeout; ++k) {
+            bound_reached = false;
+            if(search(k, check_lengths)) {
+                return l_true;
+            }
+            if(!bound_reached) {
+                break;
+            }
+        }
+        return l_undef;
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @brief Search for solutions of string constraints among words of bounded length.
+ *
+ * Used by theory_str_noodler to find short solutions before noodlification and by the string plugin of the
+ *  euf core to obtain the words of a model of a satisfiable instance.
+ */
+
+#ifndef Z3_NOODLER_BOUNDED_SEARCH_H
+#define Z3_NOODLER_BOUNDED_SEARCH_H
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ast/seq_decl_plugin.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "util/obj_hashtable.h"
+#include "util/stopwatch.h"
+
+namespace smt::noodler {
+
+    class BoundedSearch {
+    public:
+        /// Callback checking that the lengths of the words of a complete assignment are consistent.
+        using LengthCheck = std::function<bool(const ptr_vector<expr>& vars, const std::vector<zstring>& words)>;
+
+        /**
+         * @brief Create a search over the constraints added by add_equation(), add_disequation() and
+         *  add_membership().
+         *
+         * @param term2var Optional replacement of string terms by variables, applied to the arguments of
+         *  concatenations (the terms are treated as the variables they map to)
+         */
+        BoundedSearch(ast_manager& m, seq_util& m_util_s, th_rewriter& rewrite,
+                      const obj_map<expr, expr*>* term2var = nullptr);
+
+        void add_equation(expr* left, expr* right);
+        void add_disequation(expr* left, expr* right);
+        void add_membership(expr* str, expr* re, bool is_true);
+
+        /**
+         * @brief Search for a solution of the constraints.
+         *
+         * The string variables are assigned words over @p alphabet with increasing length bound
+         * k = 0, ..., @p max_len (iterative deepening). Equations where a single unassigned variable
+         * occurs once are solved for that variable, the other variables are enumerated. Constraints
+         * are checked as soon as all their variables are assigned: (dis)equations by comparing words,
+         * memberships by rewriting the membership of the word. Complete assignments must also pass
+         * @p check_lengths. The search stops after @p time_budget milliseconds, and as soon as a larger
+         * bound cannot lead to new assignments (no variable needed to be enumerated).
+         *
+         * @return l_true if a solution was found (see get_vars() and get_word()), l_undef otherwise (the
+         *  search never refutes)
+         */
+        lbool solve(const std::set<uint32_t>& alphabet, unsigned max_len, unsigned time_budget, const LengthCheck& check_lengths);
+
+        /// Variables of the constraints, ordered by their ids.
+        const ptr_vector<expr>& get_vars() const { return vars; }
+        /// Word of the i-th variable of get_vars() in the found solution.
+        const zstring& get_word(unsigned i) const { return value[i]; }
+
+    private:
+        using side = std::vector<expr*>;
+
+        ast_manager& m;
+        seq_util& m_util_s;
+        th_rewriter& m_rewrite;
+        const obj_map<expr, expr*>* term2var;
+
+        std::vector<std::pair<side, side>> eqs, diseqs;
+        std::vector<side> memb_sides;
+        std::vector<std::pair<expr_ref, bool>> memb_langs;
+        // the search evaluates only concatenations of variables and literals
+        bool supported = true;
+
+        // string variables and their (partial) assignment
+        obj_hashtable<expr> var_set;
+        ptr_vector<expr> vars;
+        obj_map<expr, unsigned> var2idx;
+        std::vector<zstring> value;
+        std::vector<bool> assigned;
+        unsigned_vector trail;
+
+        // results of the memberships of words, indexed by the membership
+        std::vector<std::map<std::string, bool>> memb_cache;
+
+        std::vector<unsigned> symbols;
+        unsigned timeout_ms = 0;
+        stopwatch sw;
+        bool timeout = false;
+        // some variable was enumerated up to the current bound
+        bool bound_reached = false;
+
+        void flatten(expr* e, side& s);
+        void add_vars(const side& s);
+        bool is_var(expr* e) const { return var2idx.contains(e); }
+
+        void assign(unsigned i, const zstring& w);
+        void undo(unsigned sz);
+        bool eval(const side& s, zstring& w) const;
+        bool check_memb(unsigned i, const zstring& w);
+        bool propagate();
+        bool out_of_budget();
+        bool search(unsigned k, const LengthCheck& check_lengths);
+    };
+}
+
+#endif
@@ -94,7 +94,8 @@ namespace smt::noodler {
     }
 
     DecisionProcedure::DecisionProcedure(ast_manager& m, seq_util& m_util_s, arith_util& m_util_a, const theory_str_noodler_params& par) 
-        : prep_handler(Formula(), AutAssignment(), {}, par), m{ m }, m_util_s{ m_util_s },
+        : len_arena(std::make_shared<LenNodeArena>()), len_expr_cache(),
+        prep_handler(Formula(), AutAssignment(), {}, par, len_arena), m{ m }, m_util_s{ m_util_s },
         m_util_a{ m_util_a },
         init_length_sensitive_vars{ },
         formula { },
@@ -113,6 +114,12 @@ namespace smt::noodler {
             SolvingState element_to_process = std::move(worklist.front());
             worklist.pop_front();
 
+            if (event_log) {
+                event_log->log(EventType::StatePop, element_to_process.id, element_to_process.parent_id,
+                               element_to_process.inclusions_to_process.size(), worklist.size(), 0,
+                               element_to_process.inclusions_to_process.empty());
+            }
+
             if (element_to_process.inclusions_to_process.empty()) {
                 // we found another solution, element_to_process contain the automata
                 // assignment and variable substition that satisfy the original
@@ -201,11 +208,7 @@ namespace smt::noodler {
 
                 // TODO: should we really push to front when not on cycle?
                 // TODO: maybe for this case of one side being empty, we should just push to front?
-                if (!is_inclusion_to_process_on_cycle) {
-                    worklist.push_front(element_to_process);
-                } else {
-                    worklist.push_back(element_to_process);
-                }
+                push_to_worklist(std::move(element_to_process), !is_inclusion_to_process_on_cycle);
                 continue;
             }
             /********************************************************************************************************/
@@ -320,12 +323,21 @@ namespace smt::noodler {
                 // we have no length-aware variables on the right hand side => we need to check if inclusion holds
                 assert(right_side_automata.size() == 1); // there should be exactly one element in right_side_automata as we do not have length variables
                 // TODO probably we should try shortest words, it might work correctly
-                if (is_inclusion_to_process_on_cycle // we do not test inclusion if we have node that is not on cycle, because we will not go back to it (TODO: should we really not test it?)
-                    && Mata::Nfa::is_included(element_to_process.aut_ass.get_automaton_concat(left_side_vars), *right_side_automata[0])) {
-                    // TODO can I push to front? I think I can, and I probably want to, so I can immediately test if it is not sat (if element_to_process.inclusions_to_process is empty), or just to get to sat faster
-                    worklist.push_front(element_to_process);
-                    // we continue as there is no need for noodlification, inclusion already holds
-                    continue;
+                // we do not test inclusion if we have node that is not on cycle, because we will not go back to it (TODO: should we really not test it?)
+                if (is_inclusion_to_process_on_cycle) {
+                    const uint64_t started = event_log ? event_log->now() : 0;
+                    const auto left_automaton = element_to_process.aut_ass.get_automaton_concat(left_side_vars);
+                    const bool holds = Mata::Nfa::is_included(left_automaton, *right_side_automata[0]);
+                    if (event_log) {
+                        event_log->log_since(started, EventType::InclusionCheck, element_to_process.id, 0,
+                                             left_automaton.size(), right_side_automata[0]->size(), 0, holds);
+                    }
+                    if (holds) {
+                        // TODO can I push to front? I think I can, and I probably want to, so I can immediately test if it is not sat (if element_to_process.inclusions_to_process is empty), or just to get to sat faster
+                        push_to_worklist(std::move(element_to_process), true);
+                        // we continue as there is no need for noodlification, inclusion already holds
+                        continue;
+                    }
                 }
             }
             /********************************************************************************************************/
@@ -367,14 +379,22 @@ namespace smt::noodler {
              * i_l-th left var (i.e. left_side_vars[i_l]) and the second element i_r = noodle[i].second[1] tell us that
              * it belongs to the i_r-th division of the right side (i.e. right_side_division[i_r])
              **/
+            const uint64_t noodlify_started = event_log ? event_log->now() : 0;
             auto noodles = Mata::Strings::SegNfa::noodlify_for_equation(left_side_automata, 
                                                                         right_side_automata,
                                                                         false, 
                                                                         {{"reduce", "true"}});
+            noodles_no += noodles.size();
+            if (event_log) {
+                event_log->log_since(noodlify_started, EventType::Noodlification, element_to_process.id, 0,
+                                     left_side_automata.size(), right_side_automata.size(), noodles.size());
+            }
 
             for (const auto &noodle : noodles) {
                 STRACE("str", tout << "Processing noodle" << std::endl; );
                 SolvingState new_element = element_to_process;
+                new_element.id = ++states_no;
+                new_element.parent_id = element_to_process.id;
 
                 /* Explanation of the next code on an example:
                  * Left side has variables x_1, x_2, x_3, x_2 while the right side has variables x_4, x_1, x_5, x_6, where x_1
@@ -506,11 +526,7 @@ namespace smt::noodler {
                 new_element.substitution_map.merge(substitution_map);
 
                 // TODO should we really push to front when not on cycle?
-                if (!is_inclusion_to_process_on_cycle) {
-                    worklist.push_front(new_element);
-                } else {
-                    worklist.push_back(new_element);
-                }
+                push_to_worklist(std::move(new_element), !is_inclusion_to_process_on_cycle);
 
             }
 
@@ -553,7 +569,7 @@ namespace smt::noodler {
         expr_ref prep_formula = util::len_to_expr(
                 this->prep_handler.get_len_formula(),
                 variable_map,
-                this->m, this->m_util_s, this->m_util_a );
+                this->m, this->m_util_s, this->m_util_a, &this->len_expr_cache );
 
         if(!this->m.is_true(prep_formula)) {
             lengths = this->m.mk_and(lengths, prep_formula);
@@ -674,7 +690,20 @@ namespace smt::noodler {
             }
         }
 
-        worklist.push_back(initialWlEl);
+        initialWlEl.id = ++states_no;
+        push_to_worklist(std::move(initialWlEl), false);
+    }
+
+    void DecisionProcedure::push_to_worklist(SolvingState state, bool to_front) {
+        if (event_log) {
+            event_log->log(EventType::StatePush, state.id, state.parent_id, state.inclusions_to_process.size(),
+                           worklist.size() + 1, 0, to_front);
+        }
+        if (to_front) {
+            worklist.push_front(std::move(state));
+        } else {
+            worklist.push_back(std::move(state));
+        }
     }
 
     /**
@@ -684,7 +713,7 @@ namespace smt::noodler {
         // As a first preprocessing operation, convert string literals to fresh variables with automata assignment
         //  representing their string literal.
         conv_str_lits_to_fresh_lits();
-        this->prep_handler = FormulaPreprocess(this->formula, this->init_aut_ass, this->init_length_sensitive_vars, m_params);
+        this->prep_handler = FormulaPreprocess(this->formula, this->init_aut_ass, this->init_length_sensitive_vars, m_params, this->len_arena);
 
         // So-far just lightweight preprocessing
         this->prep_handler.propagate_variables();
@@ -769,7 +798,7 @@ namespace smt::noodler {
         this->init_length_sensitive_vars = init_length_sensitive_vars;
         this->formula = equalities;
         this->init_aut_ass = init_aut_ass;
-        this->prep_handler = FormulaPreprocess(equalities, init_aut_ass, init_length_sensitive_vars, m_params);
+        this->prep_handler = FormulaPreprocess(equalities, init_aut_ass, init_length_sensitive_vars, m_params, this->len_arena);
     }
 
     void DecisionProcedure::conv_str_lits_to_fresh_lits() {
@@ -811,7 +840,8 @@ namespace smt::noodler {
              const std::unordered_set<BasicTerm>& init_length_sensitive_vars,
              ast_manager& m, seq_util& m_util_s, arith_util& m_util_a,
              const theory_str_noodler_params& par
-     ) : prep_handler(equalities, init_aut_ass, init_length_sensitive_vars, par), m{ m }, m_util_s{ m_util_s },
+     ) : len_arena(std::make_shared<LenNodeArena>()), len_expr_cache(),
+     prep_handler(equalities, init_aut_ass, init_length_sensitive_vars, par, len_arena), m{ m }, m_util_s{ m_util_s },
      m_util_a{ m_util_a },
      init_length_sensitive_vars{ init_length_sensitive_vars },
          formula { equalities },
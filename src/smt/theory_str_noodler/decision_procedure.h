@@ -11,6 +11,7 @@
 #include "aut_assignment.h"
 #include "state_len.h"
 #include "formula_preprocess.h"
+#include "event_log.h"
 
 namespace smt::noodler {
 
@@ -135,6 +136,10 @@ namespace smt::noodler {
         // the variables that have length constraint on them in the rest of formula
         std::unordered_set<BasicTerm> length_sensitive_vars;
 
+        // identifier of the state and of the state it was created from (used only for tracing the search)
+        unsigned id = 0;
+        unsigned parent_id = 0;
+
 
         SolvingState() = default;
         SolvingState(AutAssignment aut_ass,
@@ -269,6 +274,17 @@ namespace smt::noodler {
         // counter of noodlifications, so that newly created variables will have unique names per noodlification
         // by for example setting the name to VAR_PREFIX + "_" + noodlification_no + "_" + index_in_the_noodle
         unsigned noodlification_no = 0;
+        // number of noodles produced by all noodlifications so far (for statistics)
+        unsigned noodles_no = 0;
+        // number of solving states created so far, used as their identifiers
+        unsigned states_no = 0;
+        // log of the search, not owned (nullptr if the search is not traced)
+        EventLog* event_log = nullptr;
+
+        // region owning length formulae created during the preprocessing (shared with prep_handler)
+        std::shared_ptr<LenNodeArena> len_arena;
+        // length formulae already converted to z3 expressions
+        util::LenExprCache len_expr_cache;
 
         FormulaPreprocess prep_handler;
 
@@ -315,6 +331,11 @@ namespace smt::noodler {
 
         bool check_diseqs(const AutAssignment& ass);
 
+        /**
+         * @brief Add @p state to the front (if @p to_front) or to the back of the worklist.
+         */
+        void push_to_worklist(SolvingState state, bool to_front);
+
     public:
         DecisionProcedure(ast_manager& m, seq_util& m_util_s, arith_util& m_util_a, const theory_str_noodler_params& par);
 
@@ -351,6 +372,21 @@ namespace smt::noodler {
 
         expr_ref mk_len_aut(const expr_ref& var, std::set<std::pair<int, int>>& aut_constr);
 
+        /**
+         * @brief Get the number of noodles explored by the procedure so far.
+         */
+        unsigned get_num_noodles() const { return noodles_no; }
+
+        /**
+         * @brief Set the log where the events of the search are written to (nullptr disables the logging).
+         */
+        void set_event_log(EventLog* log) { event_log = log; }
+
+        /**
+         * @brief Get the identifier of the solving state of the last found solution.
+         */
+        unsigned get_solution_id() const { return solution.id; }
+
     };
 }
 
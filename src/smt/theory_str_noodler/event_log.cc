@@ -0,0 +1,25 @@
+#include "event_log.h"
+
+namespace smt::noodler {
+
+    EventLog::EventLog(const std::string& path) : out(path, std::ios::binary | std::ios::trunc),
+                                                  start(std::chrono::steady_clock::now()) {
+        if (out.is_open()) {
+            buffer.reserve(BUFFER_SIZE);
+            out.write(MAGIC, sizeof(MAGIC));
+        }
+    }
+
+    EventLog::~EventLog() {
+        flush();
+    }
+
+    void EventLog::flush() {
+        if (!out.is_open() || buffer.empty()) {
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Event)));
+        out.flush();
+        buffer.clear();
+    }
+}
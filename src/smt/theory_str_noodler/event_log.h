@@ -0,0 +1,132 @@
+/**
+ * @brief Low-overhead binary trace of the noodler search.
+ *
+ * The log is a file starting with an 8-byte magic (EventLog::MAGIC) followed by a sequence of fixed-size records
+ *  (struct Event, 40 bytes, little-endian on all supported platforms). The records are buffered in memory and written
+ *  in blocks, so logging an event costs only a clock read and a copy. The trace is meant to be read offline, see
+ *  contrib/noodler_events/summarize_events.py.
+ */
+
+#ifndef Z3_NOODLER_EVENT_LOG_H
+#define Z3_NOODLER_EVENT_LOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace smt::noodler {
+
+    /**
+     * @brief Types of logged events. The meaning of the generic fields of Event for each type:
+     *
+     *  type             | state            | parent          | size1          | size2          | size3         | result
+     *  -----------------|------------------|-----------------|----------------|----------------|---------------|---------
+     *  FinalCheckBegin  | final check no.  | -               | #equations     | #disequations  | #memberships  | -
+     *  FinalCheckEnd    | final check no.  | -               | #len. checks   | -              | -             | final_check_status
+     *  StatePop         | state id         | parent state id | #to process    | worklist size  | -             | 1 iff solution
+     *  StatePush        | state id         | parent state id | #to process    | worklist size  | -             | 1 iff pushed to front
+     *  InclusionCheck   | state id         | -               | left states    | right states   | -             | 1 iff holds
+     *  Noodlification   | state id         | -               | #left automata | #right automata| #noodles      | -
+     *  LengthCheck      | state id         | final check no. | -              | -              | -             | lbool
+     *  BlockingLemma    | -                | final check no. | #equations     | #disequations  | #memberships  | -
+     *
+     * The sizes are saturated to 32 bits. Events with a duration (FinalCheckEnd, InclusionCheck, Noodlification,
+     *  LengthCheck) have their timestamp set to the start of the measured operation.
+     */
+    enum class EventType : uint8_t {
+        FinalCheckBegin = 1,
+        FinalCheckEnd,
+        StatePop,
+        StatePush,
+        InclusionCheck,
+        Noodlification,
+        LengthCheck,
+        BlockingLemma,
+    };
+
+    /// One record of the event log, the layout is fixed (no implicit padding), do not reorder the members.
+    struct Event {
+        uint64_t time;      // nanoseconds since the log was opened
+        uint64_t duration;  // nanoseconds, 0 for instant events
+        uint32_t state;
+        uint32_t parent;
+        uint32_t size1;
+        uint32_t size2;
+        uint32_t size3;
+        uint8_t type;
+        uint8_t result;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(Event) == 40, "the event log format expects 40-byte records");
+
+    class EventLog {
+    public:
+        static constexpr char MAGIC[8] = { 'N', 'O', 'O', 'D', 'L', 'E', 'V', '1' };
+
+        /**
+         * @brief Create a log writing into the file @p path (the file is truncated).
+         *
+         * If the file cannot be opened, the log stays closed (is_open() is false) and all events are dropped.
+         */
+        explicit EventLog(const std::string& path);
+        ~EventLog();
+
+        EventLog(const EventLog&) = delete;
+        EventLog& operator=(const EventLog&) = delete;
+
+        bool is_open() const { return out.is_open(); }
+
+        /// Current timestamp (nanoseconds since the log was opened), used as the start of a measured operation.
+        uint64_t now() const {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+
+        /**
+         * @brief Log an instant event.
+         */
+        void log(EventType type, uint64_t state, uint64_t parent = 0, uint64_t size1 = 0, uint64_t size2 = 0,
+                 uint64_t size3 = 0, uint8_t result = 0) {
+            add(now(), 0, type, state, parent, size1, size2, size3, result);
+        }
+
+        /**
+         * @brief Log an event of an operation started at @p started (obtained by now()) and finished just now.
+         */
+        void log_since(uint64_t started, EventType type, uint64_t state, uint64_t parent = 0, uint64_t size1 = 0,
+                       uint64_t size2 = 0, uint64_t size3 = 0, uint8_t result = 0) {
+            const uint64_t finished = now();
+            add(started, finished - started, type, state, parent, size1, size2, size3, result);
+        }
+
+        /// Write all buffered events to the file.
+        void flush();
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 4096;
+
+        std::ofstream out;
+        std::vector<Event> buffer;
+        const std::chrono::steady_clock::time_point start;
+
+        static uint32_t saturate(uint64_t val) {
+            return val > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(val);
+        }
+
+        void add(uint64_t time, uint64_t duration, EventType type, uint64_t state, uint64_t parent,
+                 uint64_t size1, uint64_t size2, uint64_t size3, uint8_t result) {
+            if (!out.is_open()) {
+                return;
+            }
+            buffer.push_back({ time, duration, saturate(state), saturate(parent), saturate(size1), saturate(size2),
+                               saturate(size3), static_cast<uint8_t>(type), result, 0 });
+            if (buffer.size() >= BUFFER_SIZE) {
+                flush();
+            }
+        }
+    };
+}
+
+#endif
@@ -141,26 +141,61 @@ namespace smt::noodler {
     struct LenNode {
         LenFormulaType type;
         BasicTerm atom_val;
-        std::vector<struct LenNode*> succ;
+        std::vector<const struct LenNode*> succ;
 
-        LenNode(LenFormulaType tp, const BasicTerm& val, const std::vector<struct LenNode*>& s) : type(tp), atom_val(val), succ(s) { };
-        LenNode(LenFormulaType tp, const std::vector<struct LenNode*>& s) : type(tp), atom_val(BasicTerm(BasicTermType::Length)), succ(s) { };
+        LenNode(LenFormulaType tp, const BasicTerm& val, const std::vector<const struct LenNode*>& s) : type(tp), atom_val(val), succ(s) { };
+        LenNode(LenFormulaType tp, const std::vector<const struct LenNode*>& s) : type(tp), atom_val(BasicTerm(BasicTermType::Length)), succ(s) { };
 
-        ~LenNode() { // as a matter of fact do not clean the whole formula (root is not cleaned; but I don't care)
-            for(size_t i = 0; i < succ.size(); i++) {
-                delete succ[i];
-            }
+        /**
+         * @brief Structural equality. Successors are compared by their addresses as they are
+         * supposed to be hash-consed in a LenNodeArena.
+         */
+        bool operator==(const LenNode& other) const {
+            return type == other.type && atom_val == other.atom_val && succ == other.succ;
         }
+
+        struct HashFunction {
+            size_t operator() (const LenNode& node) const {
+                size_t res = std::hash<LenFormulaType>()(node.type) ^ (BasicTerm::HashFunction()(node.atom_val) << 1);
+                for(const LenNode* s : node.succ) {
+                    res = res * 31 + std::hash<const LenNode*>()(s);
+                }
+                return res;
+            }
+        };
     };
 
-    class LenFormula {
+    /**
+     * @brief Region owning the nodes of length formulae. Nodes are hash-consed, i.e., each structurally
+     * distinct node (e.g. the leaf |x|) is created only once and shared among all formulae built
+     * in the same arena. All nodes are released together with the arena.
+     */
+    class LenNodeArena {
     private:
-        LenNode* root;
+        // node-based container, addresses of the elements are stable
+        std::unordered_set<LenNode, LenNode::HashFunction> nodes;
 
     public:
-        LenFormula(LenNode* rt) : root(rt) { };
-        ~LenFormula() { delete this->root; };
+        LenNodeArena() : nodes() { };
+        LenNodeArena(const LenNodeArena&) = delete;
+        LenNodeArena& operator=(const LenNodeArena&) = delete;
+
+        const LenNode* mk_node(LenFormulaType tp, const BasicTerm& val, const std::vector<const LenNode*>& s) {
+            return &*this->nodes.emplace(tp, val, s).first;
+        }
+
+        const LenNode* mk_node(LenFormulaType tp, const std::vector<const LenNode*>& s) {
+            return &*this->nodes.emplace(tp, s).first;
+        }
+
+        /**
+         * @brief Create leaf |@p term|. For terms of the type BasicTermType::Length the leaf represents
+         * the number stored in the name of the term.
+         */
+        const LenNode* mk_leaf(const BasicTerm& term) { return mk_node(LenFormulaType::LEAF, term, {}); }
+        const LenNode* mk_num(int num) { return mk_leaf(BasicTerm(BasicTermType::Length, std::to_string(num))); }
 
+        size_t size() const { return this->nodes.size(); }
     };
 
     //----------------------------------------------------------------------------------------------------------------------------------
@@ -264,31 +299,29 @@ namespace smt::noodler {
          * @brief Get the length formula of the equation. For an equation X1 X2 X3 ... = Y1 Y2 Y3 ...
          * creates a formula |X1|+|X2|+|X3|+ ... = |Y1|+|Y2|+|Y3|+ ...
          *
-         * @return LenNode* Root of the length formula
+         * @param arena Arena where the nodes of the formula are allocated
+         * @return const LenNode* Root of the length formula
          */
-        LenNode* get_formula_eq() const {
+        const LenNode* get_formula_eq(LenNodeArena& arena) const {
             assert(is_equation());
-            LenNode* left, *right;
 
             auto plus_chain = [&](const std::vector<BasicTerm>& side) {
-                std::vector<LenNode*> ops;
                 if(side.size() == 0) {
-                    return new LenNode(LenFormulaType::LEAF, BasicTerm(BasicTermType::Length, "0"), {});
+                    return arena.mk_num(0);
                 }
                 if(side.size() == 1) {
-                    return new LenNode(LenFormulaType::LEAF, side[0], {});
+                    return arena.mk_leaf(side[0]);
                 }
+                std::vector<const LenNode*> ops;
                 for(const BasicTerm& t : side) {
-                    LenNode *n = new LenNode(LenFormulaType::LEAF, t, {});
-                    ops.push_back(n);
+                    ops.push_back(arena.mk_leaf(t));
                 }
-                return new LenNode(LenFormulaType::PLUS, ops);
+                return arena.mk_node(LenFormulaType::PLUS, ops);
             };
 
-            left = plus_chain(this->params[0]);
-            right = plus_chain(this->params[1]);
-            LenNode* eq = new LenNode(LenFormulaType::EQ, {left, right});
-            return eq;
+            const LenNode* left = plus_chain(this->params[0]);
+            const LenNode* right = plus_chain(this->params[1]);
+            return arena.mk_node(LenFormulaType::EQ, {left, right});
         }
 
         std::vector<BasicTerm>& get_side(EquationSideType side);
@@ -382,7 +382,7 @@ namespace smt::noodler {
             assert(eq.get_left_side().size() == 1 && eq.get_right_side().size() == 1);
             BasicTerm v_left = eq.get_left_side()[0]; // X
             update_reg_constr(v_left, eq.get_right_side()); // L(X) = L(X) cap L(Y)
-            this->len_formulae.push_back(eq.get_formula_eq()); // add len constraint |X| = |Y|
+            this->len_formulae.push_back(eq.get_formula_eq(*this->len_arena)); // add len constraint |X| = |Y|
             // propagate len variables: if Y is in len_variables, include also X
             if(this->len_variables.find(eq.get_right_side()[0]) != this->len_variables.end()) {
                 this->len_variables.insert(v_left);
@@ -675,7 +675,7 @@ namespace smt::noodler {
             }
             this->formula.replace(Concat({t}), Concat());
             // add len constraint |X| = 0
-            this->len_formulae.push_back(Predicate(PredicateType::Equation, {Concat({t}), Concat()}).get_formula_eq());
+            this->len_formulae.push_back(Predicate(PredicateType::Equation, {Concat({t}), Concat()}).get_formula_eq(*this->len_arena));
             assert(t.is_variable() || t.get_name() == "");
         }
         this->formula.clean_predicates();
@@ -1044,10 +1044,8 @@ namespace smt::noodler {
             for(const BasicTerm& var : pred.get_vars()) {
                 int ln = 0;
                 if(this->aut_ass.is_co_finite(var, ln) && ln >= 0) {
-                    LenNode* right = new LenNode(LenFormulaType::LEAF, BasicTerm(BasicTermType::Length, std::to_string(ln)), {});
-                    LenNode* left = new LenNode(LenFormulaType::LEAF, var, {});
-                    LenNode* eq = new LenNode(LenFormulaType::EQ, {left, right});
-                    this->len_formulae.push_back(new LenNode(LenFormulaType::NOT, {eq}));
+                    const LenNode* eq = this->len_arena->mk_node(LenFormulaType::EQ, {this->len_arena->mk_leaf(var), this->len_arena->mk_num(ln)});
+                    this->len_formulae.push_back(this->len_arena->mk_node(LenFormulaType::NOT, {eq}));
                     this->aut_ass[var] = std::make_shared<Mata::Nfa::Nfa>(this->aut_ass.sigma_star_automaton());
                 }
             }
@@ -1156,7 +1154,7 @@ namespace smt::noodler {
             this->len_variables.insert(x1);
             this->len_variables.insert(x2);
             this->diseq_variables.insert({a1,a2});
-            this->len_formulae.push_back(Predicate(PredicateType::Equation, {Concat({x1}), Concat({x2})}).get_formula_eq()); // |x1| = |x2|
+            this->len_formulae.push_back(Predicate(PredicateType::Equation, {Concat({x1}), Concat({x2})}).get_formula_eq(*this->len_arena)); // |x1| = |x2|
 
             this->aut_ass[x1] = std::make_shared<Mata::Nfa::Nfa>(this->aut_ass.sigma_star_automaton());
             this->aut_ass[y1] = std::make_shared<Mata::Nfa::Nfa>(this->aut_ass.sigma_star_automaton());
@@ -7,6 +7,7 @@
 #include <set>
 #include <queue>
 #include <string>
+#include <memory>
 
 #include "smt/params/theory_str_noodler_params.h"
 #include <util/trace.h>
@@ -299,7 +300,9 @@ namespace smt::noodler {
         FormulaVar formula;
         unsigned fresh_var_cnt;
         AutAssignment aut_ass;
-        std::vector<LenNode*> len_formulae;
+        // arena owning the nodes of len_formulae (shared with the decision procedure)
+        std::shared_ptr<LenNodeArena> len_arena;
+        std::vector<const LenNode*> len_formulae;
         std::unordered_set<BasicTerm> len_variables;
         std::unordered_set<std::pair<BasicTerm,BasicTerm>> diseq_variables;
         theory_str_noodler_params m_params;
@@ -320,10 +323,13 @@ namespace smt::noodler {
         void gather_extended_vars(Predicate::EquationSideType side, std::set<BasicTerm>& res);
 
     public:
-        FormulaPreprocess(const Formula& conj, const AutAssignment& ass, const std::unordered_set<BasicTerm>& lv, const theory_str_noodler_params& par) :
+        FormulaPreprocess(const Formula& conj, const AutAssignment& ass, const std::unordered_set<BasicTerm>& lv, const theory_str_noodler_params& par,
+                std::shared_ptr<LenNodeArena> arena = nullptr) :
             formula(conj),
             fresh_var_cnt(0),
             aut_ass(ass),
+            len_arena(arena != nullptr ? std::move(arena) : std::make_shared<LenNodeArena>()),
+            len_formulae(),
             len_variables(lv),
             m_params(par),
             dependency() { };
@@ -335,7 +341,7 @@ namespace smt::noodler {
         const AutAssignment& get_aut_assignment() const { return this->aut_ass; }
         const Dependency& get_dependency() const { return this->dependency; }
         Dependency get_flat_dependency() const;
-        const LenNode* get_len_formula() const { return new LenNode(LenFormulaType::AND, this->len_formulae); }
+        const LenNode* get_len_formula() const { return this->len_arena->mk_node(LenFormulaType::AND, this->len_formulae); }
         const std::unordered_set<BasicTerm>& get_len_variables() const { return this->len_variables; }
 
         Formula get_modified_formula() const;
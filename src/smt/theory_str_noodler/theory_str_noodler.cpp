@@ -7,6 +7,7 @@ Eternal glory to Yu-Fang.
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <functional>
 #include "ast/ast_pp.h"
 #include "smt/theory_str_noodler/theory_str_noodler.h"
 #include "smt/smt_context.h"
@@ -17,15 +18,11 @@ Eternal glory to Yu-Fang.
 #include "ast/seq_decl_plugin.h"
 #include "ast/reg_decl_plugins.h"
 #include "decision_procedure.h"
+#include "bounded_search.h"
 #include <mata/nfa.hh>
 
 
 namespace smt::noodler {
-    bool theory_str_noodler::is_over_approximation = false;
-
-    namespace {
-        bool IN_CHECK_FINAL = false;
-    }
 
     theory_str_noodler::theory_str_noodler(context& ctx, ast_manager & m, theory_str_noodler_params const & params):
         theory(ctx, ctx.get_manager().mk_family_id("seq")),
@@ -34,16 +31,42 @@ namespace smt::noodler {
         m_util_a(m),
         m_util_s(m),
         state_len(),
-        m_length(m) {
+        m_shape_pins(m),
+        m_lazy_pins(m),
+        m_length(m),
+        m_event_log_path(params.m_event_log) {
+    }
+
+    theory *theory_str_noodler::mk_fresh(context * newctx) {
+        // the copy lives in newctx (possibly with its own manager used by another thread), so it
+        // must not refer to anything owned by this instance or by its context
+        theory_str_noodler* th = alloc(theory_str_noodler, *newctx, newctx->get_manager(), newctx->get_fparams());
+        if (!m_event_log_path.empty()) {
+            th->m_event_log_path = m_event_log_path + "." + std::to_string(++m_num_fresh);
+        }
+        return th;
     }
 
     void theory_str_noodler::display(std::ostream &os) const {
         os << "theory_str display" << std::endl;
     }
 
+    void theory_str_noodler::collect_statistics(::statistics & st) const {
+        st.update("str final checks", m_stats.m_num_final_checks);
+        st.update("str noodles", m_stats.m_num_noodles);
+        st.update("str length checks", m_stats.m_num_len_checks);
+        st.update("str underapprox sat", m_stats.m_num_underapprox_sat);
+        st.update("str shared shapes", m_stats.m_num_shared_shapes);
+        st.update("str lazy axioms", m_stats.m_num_lazy_axioms);
+        st.update("str concrete sat", m_stats.m_num_concrete_sat);
+        st.update("str concrete conflicts", m_stats.m_num_concrete_conflicts);
+        st.update("str concrete dropped", m_stats.m_num_concrete_dropped);
+        st.update("str bounded sat", m_stats.m_num_bounded_sat);
+    }
+
     void theory_str_noodler::init() {
         theory::init();
-        STRACE("str", if (!IN_CHECK_FINAL) tout << "init\n";);
+        STRACE("str", if (!m_in_final_check) tout << "init\n";);
     }
 
     enode *theory_str_noodler::ensure_enode(expr *e) {
@@ -482,6 +505,7 @@ namespace smt::noodler {
         } else if (m_util_s.str.is_contains(e, e1, e2)) {
             if (is_true) {
                 handle_contains(e);
+                instantiate_lazy_axioms(e);
             } else {
                 handle_not_contains(e);
             }
@@ -560,7 +584,7 @@ namespace smt::noodler {
     }
 
     void theory_str_noodler::propagate() {
-        // STRACE("str", if (!IN_CHECK_FINAL) tout << "o propagate" << '\n';);
+        // STRACE("str", if (!m_in_final_check) tout << "o propagate" << '\n';);
 
         // for(const expr_ref& ex : this->len_state_axioms)
         //     add_axiom(ex);
@@ -574,7 +598,7 @@ namespace smt::noodler {
         m_word_diseq_var_todo.push_scope();
         m_membership_todo.push_scope();
         m_not_contains_todo.push_scope();
-        STRACE("str", if (!IN_CHECK_FINAL) tout << "push_scope: " << m_scope_level << '\n';);
+        STRACE("str", if (!m_in_final_check) tout << "push_scope: " << m_scope_level << '\n';);
     }
 
     void theory_str_noodler::pop_scope_eh(const unsigned num_scopes) {
@@ -588,7 +612,7 @@ namespace smt::noodler {
         m_membership_todo.pop_scope(num_scopes);
         m_not_contains_todo.pop_scope(num_scopes);
         m_rewrite.reset();
-        STRACE("str", if (!IN_CHECK_FINAL)
+        STRACE("str", if (!m_in_final_check)
             tout << "pop_scope: " << num_scopes << " (back to level " << m_scope_level << ")\n";);
     }
 
@@ -699,10 +723,39 @@ namespace smt::noodler {
     Final check for an assignment of the underlying boolean skeleton.
     */
     final_check_status theory_str_noodler::final_check_eh() {
+        ++m_stats.m_num_final_checks;
+
+        if (!m_event_log_path.empty() && !m_event_log) {
+            m_event_log = std::make_unique<EventLog>(m_event_log_path);
+            if (!m_event_log->is_open()) {
+                warning_msg("could not open the event log %s", m_event_log_path.c_str());
+            }
+        }
+
+        const uint64_t started = m_event_log ? m_event_log->now() : 0;
+        const unsigned len_checks = m_stats.m_num_len_checks;
+        m_in_final_check = true;
+        final_check_status ret = final_check_core();
+        m_in_final_check = false;
+        if (m_event_log) {
+            m_event_log->log_since(started, EventType::FinalCheckEnd, m_stats.m_num_final_checks, 0,
+                                   m_stats.m_num_len_checks - len_checks, 0, 0, ret);
+            // the solver may be terminated right after the final check, keep the log on disk consistent
+            m_event_log->flush();
+        }
+        return ret;
+    }
+
+    final_check_status theory_str_noodler::final_check_core() {
         TRACE("str", tout << "final_check starts\n";);
 
         remove_irrelevant_constr();
 
+        if (m_event_log) {
+            m_event_log->log(EventType::FinalCheckBegin, m_stats.m_num_final_checks, 0, m_word_eq_todo_rel.size(),
+                             m_word_diseq_todo_rel.size(), m_membership_todo_rel.size());
+        }
+
         STRACE("str", tout << "eq: " << this->m_word_eq_todo_rel.size() << " diseq: " << this->m_word_diseq_todo_rel.size() << " res: " << this->m_membership_todo_rel.size() << std::endl);
 
         // difficult not(contains) predicates -> unknown
@@ -710,6 +763,17 @@ namespace smt::noodler {
             return FC_GIVEUP;
         }
 
+        // decide the constraints over concrete words directly, keep only the symbolic residue
+        // (the instance below is built from the remaining constraints)
+        switch(solve_concrete()) {
+        case l_true:
+            return FC_DONE;
+        case l_false:
+            return FC_CONTINUE;
+        default:
+            break;
+        }
+
         expr* fls = nullptr; // false term
         obj_hashtable<expr> conj;
         obj_hashtable<app> conj_instance;
@@ -773,6 +837,21 @@ namespace smt::noodler {
 
         // Add dummy symbols for all disequations.
         std::set<uint32_t> dummy_symbols{ util::get_dummy_symbols(std::max(new_symbs, size_t(3)), symbols_in_formula) };
+        // look for short solutions before building the automata
+        if(m_params.m_bounded_len > 0) {
+            std::set<uint32_t> bounded_alphabet;
+            for(uint32_t s : symbols_in_formula) {
+                if(dummy_symbols.find(s) == dummy_symbols.end()) {
+                    bounded_alphabet.insert(s);
+                }
+            }
+            // one dummy symbol stands for the characters not occurring in the formula
+            bounded_alphabet.insert(*dummy_symbols.begin());
+            if(solve_bounded(bounded_alphabet) == l_true) {
+                return FC_DONE;
+            }
+        }
+
         // Create automata assignment for the formula.
         AutAssignment aut_assignment{util::create_aut_assignment_for_formula(
                 instance, m_membership_todo_rel, this->var_name, m_util_s, m, symbols_in_formula
@@ -784,10 +863,12 @@ namespace smt::noodler {
         // use underapproximation to solve
         if(m_params.m_underapproximation && solve_underapprox(instance, aut_assignment, init_length_sensitive_vars) == l_true) {
             STRACE("str", tout << "underapprox sat \n";);
+            ++m_stats.m_num_underapprox_sat;
             return FC_DONE;
         }
 
         DecisionProcedure dec_proc = DecisionProcedure{ instance, aut_assignment, init_length_sensitive_vars, m, m_util_s, m_util_a, m_params };
+        dec_proc.set_event_log(m_event_log.get());
         dec_proc.preprocess();
         
         model_ref mod;
@@ -804,8 +885,9 @@ namespace smt::noodler {
         dec_proc.init_computation();
         while(dec_proc.compute_next_solution()) {
             lengths = dec_proc.get_lengths(this->var_name);
-            if(check_len_sat(lengths, mod) == l_true) {
+            if(check_len_sat(lengths, mod, dec_proc.get_solution_id()) == l_true) {
                 STRACE("str", tout << "len sat " << mk_pp(lengths, m););
+                m_stats.m_num_noodles += dec_proc.get_num_noodles();
                 return FC_DONE;
             }
             if(init_length_sensitive_vars.size() > 0) {
@@ -814,14 +896,262 @@ namespace smt::noodler {
             STRACE("str", tout << "len unsat\n";);
         }
 
+        m_stats.m_num_noodles += dec_proc.get_num_noodles();
+
         // all len solutions are unsat, we block the current assignment
         block_curr_len(block_len);
         //block_curr_assignment();
-        IN_CHECK_FINAL = false;
         TRACE("str", tout << "final_check ends\n";);
         return FC_CONTINUE;
     }
 
+    /**
+     * @brief Get the concrete value of a string term @p e in the current e-graph.
+     *
+     * The term has a concrete value if it is a string literal, a concatenation of terms with
+     * concrete values, or if its equivalence class contains a string literal.
+     * @param e String term
+     * @param[out] val Concrete value of @p e
+     * @param[out] var_lits Literals found in the equivalence classes of the subterms of @p e
+     * @return True iff @p e has a concrete value
+     */
+    bool theory_str_noodler::get_concrete_value(expr* e, zstring& val, obj_map<expr, expr*>& var_lits) {
+        expr* lit = nullptr, * a = nullptr, * b = nullptr;
+        if(m_util_s.str.is_string(e, val)) {
+            return true;
+        }
+        if(m_util_s.str.is_empty(e)) {
+            val = zstring();
+            return true;
+        }
+        if(m_util_s.str.is_concat(e, a, b)) {
+            zstring val_a, val_b;
+            if(!get_concrete_value(a, val_a, var_lits) || !get_concrete_value(b, val_b, var_lits)) {
+                return false;
+            }
+            val = val_a + val_b;
+            return true;
+        }
+        if(var_lits.find(e, lit)) {
+            return get_concrete_value(lit, val, var_lits);
+        }
+        if(!ctx.e_internalized(e)) {
+            return false;
+        }
+        enode* n = ctx.get_enode(e);
+        enode* curr = n;
+        do {
+            expr* c = curr->get_expr();
+            if(m_util_s.str.is_string(c) || m_util_s.str.is_empty(c)) {
+                var_lits.insert(e, c);
+                return get_concrete_value(c, val, var_lits);
+            }
+            curr = curr->get_next();
+        } while(curr != n);
+        return false;
+    }
+
+    /**
+     * @brief Decide the string constraints whose variables are fixed to string literals in the e-graph.
+     *
+     * Ground equations and disequations are decided by comparing the concrete words, ground memberships
+     * by rewriting the membership of the concrete word (i.e., by taking derivatives of the regex wrt. the
+     * characters of the word). A violated ground constraint is refuted by the lemma
+     * (x_1 = w_1 && ... && x_n = w_n) -> c. Satisfied ground constraints whose variables are not length
+     * variables and do not occur in the other constraints are removed from the current instance, so that
+     * only the symbolic residue is handed to the decision procedure.
+     *
+     * @return l_true if all constraints are ground, satisfied and consistent with the lengths, l_false if
+     *  a lemma refuting the current assignment was added, l_undef otherwise
+     */
+    lbool theory_str_noodler::solve_concrete() {
+        // variables of the ground constraints and their concrete values
+        obj_map<expr, expr*> var_lits;
+        // variables of the constraints that are not ground
+        obj_hashtable<expr> residue_vars;
+        zstring val1, val2;
+
+        // lemma (x_1 = w_1 && ... && x_n = w_n) -> concl for the variables of a ground constraint
+        auto refute = [&](obj_map<expr, expr*> const& lits, expr* concl) {
+            expr_ref_vector lemma(m);
+            for(const auto& kv : lits) {
+                lemma.push_back(m.mk_not(ctx.mk_eq_atom(kv.m_key, kv.m_value)));
+            }
+            lemma.push_back(concl);
+            STRACE("str", tout << "concrete conflict: " << mk_pp(concl, m) << std::endl;);
+            ++m_stats.m_num_concrete_conflicts;
+            add_axiom(m.mk_or(lemma));
+            return l_false;
+        };
+        auto add_vars = [&](obj_map<expr, expr*> const& lits) {
+            for(const auto& kv : lits) {
+                var_lits.insert(kv.m_key, kv.m_value);
+            }
+        };
+
+        std::vector<bool> ground_eqs, ground_diseqs, ground_membs;
+        unsigned num_ground = 0;
+
+        for(const auto& we : m_word_eq_todo_rel) {
+            obj_map<expr, expr*> lits;
+            bool ground = get_concrete_value(we.first, val1, lits) && get_concrete_value(we.second, val2, lits);
+            if(ground && val1 != val2) {
+                return refute(lits, m.mk_not(ctx.mk_eq_atom(we.first, we.second)));
+            }
+            if(ground) {
+                add_vars(lits);
+                ++num_ground;
+            } else {
+                util::get_str_variables(we.first, m_util_s, m, residue_vars);
+                util::get_str_variables(we.second, m_util_s, m, residue_vars);
+            }
+            ground_eqs.push_back(ground);
+        }
+
+        for(const auto& we : m_word_diseq_todo_rel) {
+            obj_map<expr, expr*> lits;
+            bool ground = get_concrete_value(we.first, val1, lits) && get_concrete_value(we.second, val2, lits);
+            if(ground && val1 == val2) {
+                return refute(lits, ctx.mk_eq_atom(we.first, we.second));
+            }
+            if(ground) {
+                add_vars(lits);
+                ++num_ground;
+            } else {
+                util::get_str_variables(we.first, m_util_s, m, residue_vars);
+                util::get_str_variables(we.second, m_util_s, m, residue_vars);
+            }
+            ground_diseqs.push_back(ground);
+        }
+
+        for(const auto& memb : m_membership_todo_rel) {
+            obj_map<expr, expr*> lits;
+            bool ground = false;
+            if(get_concrete_value(std::get<0>(memb), val1, lits)) {
+                expr_ref in_re(m_util_s.re.mk_in_re(m_util_s.str.mk_string(val1), std::get<1>(memb)), m);
+                m_rewrite(in_re);
+                ground = m.is_true(in_re) || m.is_false(in_re);
+                if(ground && m.is_true(in_re) != std::get<2>(memb)) {
+                    expr_ref concl(m_util_s.re.mk_in_re(std::get<0>(memb), std::get<1>(memb)), m);
+                    if(std::get<2>(memb)) {
+                        concl = m.mk_not(concl);
+                    }
+                    return refute(lits, concl);
+                }
+            }
+            if(ground) {
+                add_vars(lits);
+                ++num_ground;
+            } else {
+                util::get_str_variables(std::get<0>(memb), m_util_s, m, residue_vars);
+            }
+            ground_membs.push_back(ground);
+        }
+
+        if(num_ground == 0) {
+            return l_undef;
+        }
+
+        if(num_ground == m_word_eq_todo_rel.size() + m_word_diseq_todo_rel.size() + m_membership_todo_rel.size()) {
+            // the values of the length variables must agree with the length constraints
+            expr_ref_vector len_eqs(m);
+            for(const auto& kv : var_lits) {
+                if(len_vars.contains(kv.m_key)) {
+                    get_concrete_value(kv.m_value, val1, var_lits);
+                    len_eqs.push_back(m.mk_eq(mk_len(kv.m_key), m_util_a.mk_int(val1.length())));
+                }
+            }
+            model_ref mod;
+            if(len_eqs.empty() || check_len_sat(mk_and(len_eqs), mod) == l_true) {
+                STRACE("str", tout << "concrete sat\n";);
+                ++m_stats.m_num_concrete_sat;
+                return l_true;
+            }
+            // let the decision procedure derive the length lemma
+            return l_undef;
+        }
+
+        // keep the ground constraints that share variables with the residue or constrain lengths
+        auto is_detached = [&](obj_map<expr, expr*> const& vars) {
+            for(const auto& kv : vars) {
+                if(residue_vars.contains(kv.m_key) || len_vars.contains(kv.m_key)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto filter = [&](auto& constraints, const std::vector<bool>& ground, auto get_vars) {
+            unsigned j = 0;
+            for(unsigned i = 0; i < constraints.size(); ++i) {
+                obj_map<expr, expr*> vars;
+                if(ground[i]) {
+                    get_vars(constraints[i], vars);
+                    if(is_detached(vars)) {
+                        continue;
+                    }
+                }
+                if(i != j) {
+                    constraints[j] = constraints[i];
+                }
+                ++j;
+            }
+            m_stats.m_num_concrete_dropped += constraints.size() - j;
+            constraints.shrink(j);
+        };
+        filter(m_word_eq_todo_rel, ground_eqs, [&](const expr_pair& we, obj_map<expr, expr*>& vars) {
+            get_concrete_value(we.first, val1, vars);
+            get_concrete_value(we.second, val1, vars);
+        });
+        filter(m_word_diseq_todo_rel, ground_diseqs, [&](const expr_pair& we, obj_map<expr, expr*>& vars) {
+            get_concrete_value(we.first, val1, vars);
+            get_concrete_value(we.second, val1, vars);
+        });
+        filter(m_membership_todo_rel, ground_membs, [&](const expr_pair_flag& memb, obj_map<expr, expr*>& vars) {
+            get_concrete_value(std::get<0>(memb), val1, vars);
+        });
+        return l_undef;
+    }
+
+    /**
+     * @brief Search for a solution of the current constraints among words of bounded length (at most
+     * str.bounded_len, within str.bounded_timeout milliseconds), see BoundedSearch. Complete assignments
+     * must also agree with the length constraints.
+     *
+     * @param alphabet Symbols the words are built from
+     * @return l_true if a solution was found, l_undef otherwise (the search never refutes)
+     */
+    lbool theory_str_noodler::solve_bounded(const std::set<uint32_t>& alphabet) {
+        BoundedSearch bounded(m, m_util_s, m_rewrite);
+        for(const auto& we : m_word_eq_todo_rel) {
+            bounded.add_equation(we.first, we.second);
+        }
+        for(const auto& we : m_word_diseq_todo_rel) {
+            bounded.add_disequation(we.first, we.second);
+        }
+        for(const auto& memb : m_membership_todo_rel) {
+            bounded.add_membership(std::get<0>(memb), std::get<1>(memb), std::get<2>(memb));
+        }
+
+        // the assignment must agree with the length constraints
+        auto check_lengths = [&](const ptr_vector<expr>& vars, const std::vector<zstring>& words) {
+            expr_ref_vector len_eqs(m);
+            for(unsigned i = 0; i < vars.size(); ++i) {
+                if(len_vars.contains(vars[i])) {
+                    len_eqs.push_back(m.mk_eq(mk_len(vars[i]), m_util_a.mk_int(words[i].length())));
+                }
+            }
+            model_ref mod;
+            return len_eqs.empty() || check_len_sat(mk_and(len_eqs), mod) == l_true;
+        };
+
+        if(bounded.solve(alphabet, m_params.m_bounded_len, m_params.m_bounded_timeout, check_lengths) == l_true) {
+            STRACE("str", tout << "bounded sat" << std::endl;);
+            ++m_stats.m_num_bounded_sat;
+            return l_true;
+        }
+        return l_undef;
+    }
+
     /**
      * @brief Solve the given constraint using underapproximation.
      * 
@@ -832,6 +1162,7 @@ namespace smt::noodler {
      */
     lbool theory_str_noodler::solve_underapprox(const Formula& instance, const AutAssignment& aut_assignment, const std::unordered_set<BasicTerm>& init_length_sensitive_vars) {
         DecisionProcedure dec_proc = DecisionProcedure{ instance, aut_assignment, init_length_sensitive_vars, m, m_util_s, m_util_a, m_params };
+        dec_proc.set_event_log(m_event_log.get());
         dec_proc.preprocess(PreprocessType::UNDERAPPROX);
         
         expr_ref lengths(m);
@@ -839,10 +1170,12 @@ namespace smt::noodler {
         dec_proc.init_computation();
         while(dec_proc.compute_next_solution()) {
             lengths = dec_proc.get_lengths(this->var_name);
-            if(check_len_sat(lengths, mod) == l_true) {
+            if(check_len_sat(lengths, mod, dec_proc.get_solution_id()) == l_true) {
+                m_stats.m_num_noodles += dec_proc.get_num_noodles();
                 return l_true;
             }
         }
+        m_stats.m_num_noodles += dec_proc.get_num_noodles();
         return l_false;
     }
 
@@ -855,11 +1188,11 @@ namespace smt::noodler {
     }
 
     void theory_str_noodler::init_model(model_generator &mg) {
-        STRACE("str", if (!IN_CHECK_FINAL) tout << "init_model\n";);
+        STRACE("str", if (!m_in_final_check) tout << "init_model\n";);
     }
 
     void theory_str_noodler::finalize_model(model_generator &mg) {
-        STRACE("str", if (!IN_CHECK_FINAL) tout << "finalize_model\n";);
+        STRACE("str", if (!m_in_final_check) tout << "finalize_model\n";);
     }
 
     lbool theory_str_noodler::validate_unsat_core(expr_ref_vector &unsat_core) {
@@ -1044,7 +1377,14 @@ namespace smt::noodler {
         expr *s = nullptr, *i = nullptr, *res = nullptr;
         VERIFY(m_util_s.str.is_at(e, s, i));
 
-        expr_ref fresh = mk_str_var("at");
+        // occurrences of the same shape share the variable and its axioms
+        bool is_new = false;
+        expr_ref fresh(get_shape("at", e, nullptr, [&]() { return mk_str_var("at"); }, is_new), m);
+        if(!is_new) {
+            add_axiom({mk_eq(fresh, e, false)});
+            predicate_replace.insert(e, fresh.get());
+            return;
+        }
         expr_ref re(m_util_s.re.mk_in_re(fresh, m_util_s.re.mk_full_char(nullptr)), m);
         expr_ref zero(m_util_a.mk_int(0), m);
         literal i_ge_0 = mk_literal(m_util_a.mk_ge(i, zero));
@@ -1091,7 +1431,7 @@ namespace smt::noodler {
         }
 
         expr_ref one(m_util_a.mk_int(1), m);
-        expr_ref x = mk_str_var("at_left");
+        expr_ref x = mk_shared_str_var("prefix", s, i);
         expr_ref y = mk_str_var("at_right");
         expr_ref xey(m_util_s.str.mk_concat(x, m_util_s.str.mk_concat(fresh, y)), m);
         string_theory_propagation(xey);
@@ -1112,7 +1452,7 @@ namespace smt::noodler {
         this->len_vars.insert(x);
     }
 
-    void theory_str_noodler::handle_substr_int(expr *e) {
+    void theory_str_noodler::handle_substr_int(expr *e, const expr_ref& v) {
         expr *s = nullptr, *i = nullptr, *l = nullptr;
         VERIFY(m_util_s.str.is_extract(e, s, i, l));
 
@@ -1133,11 +1473,11 @@ namespace smt::noodler {
         literal ls_le_0 = mk_literal(m_util_a.mk_le(ls, zero));
 
         expr_ref x(m_util_s.str.mk_string(""), m);
-        expr_ref v = mk_str_var("substr");
 
         int val = r.get_int32();
         for(int i = 0; i < val; i++) {
-            expr_ref var = mk_str_var("pre_substr");
+            // the i-th character of s is the same for all substrings of s
+            expr_ref var = mk_shared_str_var("pre_substr", s, m_util_a.mk_int(i));
             expr_ref re(m_util_s.re.mk_in_re(var, m_util_s.re.mk_full_char(nullptr)), m);
             x = m_util_s.str.mk_concat(x, var);
             add_axiom({~i_ge_0, ~ls_le_i, mk_literal(re)});
@@ -1230,13 +1570,22 @@ namespace smt::noodler {
         expr *s = nullptr, *i = nullptr, *l = nullptr;
         VERIFY(m_util_s.str.is_extract(e, s, i, l));
 
+        // occurrences of the same shape share the variable and its axioms
+        bool is_new = false;
+        expr_ref v(get_shape("substr", e, nullptr, [&]() { return mk_str_var("substr"); }, is_new), m);
+        if(!is_new) {
+            add_axiom({mk_eq(v, e, false)});
+            this->predicate_replace.insert(e, v.get());
+            return;
+        }
+
         if(m_util_a.is_numeral(i)) {
-            handle_substr_int(e);
+            handle_substr_int(e, v);
             return;
         }
 
-        expr_ref v = mk_str_var("substr");
-        expr_ref x = mk_str_var("pre_substr");
+        // the prefix of s of length i is shared with other substr/at terms starting at i
+        expr_ref x = mk_shared_str_var("prefix", s, i);
         expr_ref y = mk_str_var("post_substr");
         expr_ref xe(m_util_s.str.mk_concat(x, v), m);
         expr_ref xey(m_util_s.str.mk_concat(x, v, y), m);
@@ -1292,10 +1641,13 @@ namespace smt::noodler {
      * a = eps && s != eps -> v = a
      * (not(contains(a,s))) -> v = a
      * s = eps -> v = t.a
-     * contains(a,s) && a != eps && s != eps -> a = x.s.y
-     * contains(a,s) && a != eps && s != eps -> v = x.t.y
+     * contains(a,s) && a != eps && s != eps -> a = x.s.y
+     * contains(a,s) && a != eps && s != eps -> v = x.t.y
      * tighttestprefix(s,t)
      *
+     * The axioms for the case contains(a,s) are added only once contains(a,s) becomes true (see
+     * add_replace_split_axioms()).
+     *
      * @param r replace term
      */
     void theory_str_noodler::handle_replace(expr *r) {
@@ -1308,11 +1660,16 @@ namespace smt::noodler {
         context& ctx = get_context();
         expr* a = nullptr, *s = nullptr, *t = nullptr;
         VERIFY(m_util_s.str.is_replace(r, a, s, t));
-        expr_ref v = mk_str_var("replace");
-        expr_ref x = mk_str_var("replace_left");
-        expr_ref y = mk_str_var("replace_right");
-        expr_ref xty = mk_concat(x, mk_concat(t, y));
-        expr_ref xsy = mk_concat(x, mk_concat(s, y));
+
+        // occurrences of the same shape share the variable and its axioms
+        bool is_new = false;
+        expr_ref v(get_shape("replace", r, nullptr, [&]() { return mk_str_var("replace"); }, is_new), m);
+        if(!is_new) {
+            add_axiom({mk_eq(v, r, false)});
+            predicate_replace.insert(r, v.get());
+            return;
+        }
+
         literal a_emp = mk_eq_empty(a, true);
         literal s_emp = mk_eq_empty(s, true);
         literal cnt = mk_literal(m_util_s.str.mk_contains(a, s));
@@ -1325,15 +1682,41 @@ namespace smt::noodler {
         add_axiom({cnt, mk_eq(v, a, false)});
         // s = eps -> v = t.a
         add_axiom({~s_emp, mk_eq(v, mk_concat(t, a),false)});
-        // contains(a,s) && a != eps && s != eps -> a = x.s.y
-        add_axiom({~cnt, a_emp, s_emp, mk_eq(a, xsy,false)});
-        // contains(a,s) && a != eps && s != eps -> v = x.t.y
-        add_axiom({~cnt, a_emp, s_emp, mk_eq(v, xty,false)});
         ctx.force_phase(cnt);
-        // tighttestprefix(s,t)
-        tightest_prefix(s, x);
 
         predicate_replace.insert(r, v.get());
+        add_after_contains(cnt, r);
+    }
+
+    /**
+     * @brief Add the axioms of str.replace(a,s,t) = v for the case contains(a,s):
+     * contains(a,s) && a != eps && s != eps -> a = x.s.y
+     * contains(a,s) && a != eps && s != eps -> v = x.t.y
+     * tighttestprefix(s,x)
+     *
+     * The first occurrence x.s.y of s in a is shared with indexof(a,s).
+     *
+     * @param r replace term (already handled by handle_replace())
+     */
+    void theory_str_noodler::add_replace_split_axioms(expr *r) {
+        expr* a = nullptr, *s = nullptr, *t = nullptr, *v = nullptr;
+        VERIFY(m_util_s.str.is_replace(r, a, s, t));
+        VERIFY(predicate_replace.find(r, v));
+
+        expr_ref x = mk_shared_str_var("first_left", a, s);
+        expr_ref y = mk_shared_str_var("first_right", a, s);
+        expr_ref xty = mk_concat(x, mk_concat(t, y));
+        expr_ref xsy = mk_concat(x, mk_concat(s, y));
+        literal a_emp = mk_eq_empty(a, true);
+        literal s_emp = mk_eq_empty(s, true);
+        literal cnt = mk_literal(m_util_s.str.mk_contains(a, s));
+
+        // contains(a,s) && a != eps && s != eps -> a = x.s.y
+        add_axiom({~cnt, a_emp, s_emp, mk_eq(a, xsy,false)});
+        // contains(a,s) && a != eps && s != eps -> v = x.t.y
+        add_axiom({~cnt, a_emp, s_emp, mk_eq(v, xty,false)});
+        // tighttestprefix(s,x)
+        tightest_prefix(s, x);
     }
 
     /**
@@ -1347,6 +1730,7 @@ namespace smt::noodler {
      * contains(t, s) && s != eps -> indexof = |x|
      * contains(t, s) -> indexof >= 0
      * tightestprefix(s,x)
+     * (the axioms with x are added only once contains(t,s) becomes true, see add_index_of_split_axioms())
      *
      * The case of offset > 0
      * not(contains(t,s)) -> indexof = -1
@@ -1373,6 +1757,14 @@ namespace smt::noodler {
         rational r;
         VERIFY(m_util_s.str.is_index(i, t, s) || m_util_s.str.is_index(i, t, s, offset));
 
+        // indexof terms of the same shape are equal, only the first one is axiomatized
+        bool is_new = false;
+        expr* repr = get_shape("indexof", i, nullptr, [&]() { return expr_ref(i, m); }, is_new);
+        if(!is_new) {
+            add_axiom({mk_eq(i, repr, false)});
+            return;
+        }
+
         expr_ref minus_one(m_util_a.mk_int(-1), m);
         expr_ref zero(m_util_a.mk_int(0), m);
         expr_ref emp(m_util_s.str.mk_empty(t->get_sort()), m);
@@ -1389,24 +1781,11 @@ namespace smt::noodler {
         add_axiom({~t_eq_empty, s_eq_empty, i_eq_m1});
 
         if (!offset || (m_util_a.is_numeral(offset, r) && r.is_zero())) {
-            expr_ref x = mk_str_var("index_left");
-            expr_ref y = mk_str_var("index_right");
-            expr_ref xsy(m_util_s.str.mk_concat(x, s, y), m);
-            string_theory_propagation(xsy);
-
-            expr_ref lenx(m_util_s.str.mk_length(x), m);
             // s = eps -> indexof = 0
             add_axiom({~s_eq_empty, i_eq_0});
-            // contains(t, s) && s != eps -> t = x.s.y
-            add_axiom({~cnt, s_eq_empty, mk_eq(t, xsy, false)});
-            // contains(t, s) && s != eps -> indexof = |x|
-            add_axiom({~cnt, s_eq_empty, mk_eq(i, lenx, false)});
             // contains(t, s) -> indexof >= 0
             add_axiom({~cnt, mk_literal(m_util_a.mk_ge(i, zero))});
-            tightest_prefix(s, x);
-
-            // update length variables
-            this->len_vars.insert(x);
+            add_after_contains(cnt, i);
 
         } else {
             expr_ref len_t(m_util_s.str.mk_length(t), m);
@@ -1420,8 +1799,9 @@ namespace smt::noodler {
             // offset >= |t| && offset <= |t| && s = eps -> indexof = offset
             add_axiom({~offset_ge_len, ~offset_le_len, ~s_eq_empty, i_eq_offset});
 
-            expr_ref x = mk_str_var("index_left");
-            expr_ref y = mk_str_var("index_right");
+            // t = x.y is shared by all indexof(t, _, offset); x also with substr/at terms starting at offset
+            expr_ref x = mk_shared_str_var("prefix", t, offset);
+            expr_ref y = mk_shared_str_var("suffix", t, offset);
             expr_ref xy(m_util_s.str.mk_concat(x, y), m);
             string_theory_propagation(xy);
 
@@ -1446,6 +1826,96 @@ namespace smt::noodler {
         }
     }
 
+    /**
+     * @brief Add the axioms of indexof(t,s,0) = indexof for the case contains(t,s):
+     * contains(t, s) && s != eps -> t = x.s.y
+     * contains(t, s) && s != eps -> indexof = |x|
+     * tightestprefix(s,x)
+     *
+     * The first occurrence x.s.y of s in t is shared with replace(t,s,_).
+     *
+     * @param i indexof term (already handled by handle_index_of())
+     */
+    void theory_str_noodler::add_index_of_split_axioms(expr *i) {
+        expr *s = nullptr, *t = nullptr, *offset = nullptr;
+        VERIFY(m_util_s.str.is_index(i, t, s) || m_util_s.str.is_index(i, t, s, offset));
+
+        expr_ref emp(m_util_s.str.mk_empty(t->get_sort()), m);
+        literal cnt = mk_literal(m_util_s.str.mk_contains(t, s));
+        literal s_eq_empty = mk_eq(s, emp, false);
+
+        expr_ref x = mk_shared_str_var("first_left", t, s);
+        expr_ref y = mk_shared_str_var("first_right", t, s);
+        expr_ref xsy(m_util_s.str.mk_concat(x, s, y), m);
+        string_theory_propagation(xsy);
+
+        expr_ref lenx(m_util_s.str.mk_length(x), m);
+        // contains(t, s) && s != eps -> t = x.s.y
+        add_axiom({~cnt, s_eq_empty, mk_eq(t, xsy, false)});
+        // contains(t, s) && s != eps -> indexof = |x|
+        add_axiom({~cnt, s_eq_empty, mk_eq(i, lenx, false)});
+        tightest_prefix(s, x);
+
+        // update length variables
+        this->len_vars.insert(x);
+    }
+
+    /**
+     * @brief Add the axioms of @p term (replace or indexof) that are relevant only if the contains atom
+     * of @p cnt holds. If @p cnt is not known to be true yet, the axioms are postponed until the atom is
+     * assigned to true (see instantiate_lazy_axioms()).
+     *
+     * @param cnt Literal of contains(a,s)
+     * @param term replace(a,s,_) or indexof(a,s,0)
+     */
+    void theory_str_noodler::add_after_contains(literal cnt, expr *term) {
+        expr* atom = ctx.bool_var2expr(cnt.var());
+        // the atom might have been rewritten to something else, then we cannot wait for it
+        if(cnt.sign() || atom == nullptr || !m_util_s.str.is_contains(atom) || ctx.get_assignment(cnt) == l_true) {
+            if(m_util_s.str.is_replace(term)) {
+                add_replace_split_axioms(term);
+            } else {
+                add_index_of_split_axioms(term);
+            }
+            return;
+        }
+        // the postponed axioms are valid in any scope, so the registration is kept on backtracking
+        // (the term is registered again when it becomes relevant again after a pop)
+        ptr_vector<expr>& terms = m_lazy_contains_terms.insert_if_not_there(atom, ptr_vector<expr>());
+        if(terms.contains(term)) {
+            return;
+        }
+        STRACE("str", tout << "postponing axioms of " << mk_pp(term, m) << " until " << mk_pp(atom, m) << '\n';);
+        m_lazy_pins.push_back(atom);
+        m_lazy_pins.push_back(term);
+        terms.push_back(term);
+    }
+
+    /**
+     * @brief Add the postponed axioms (see add_after_contains()) waiting for the contains atom @p cnt.
+     *
+     * The axioms are deleted when the current scope is backtracked, so the terms are put back to
+     * m_lazy_contains_terms on backtracking and instantiated again once @p cnt is true again.
+     *
+     * @param cnt contains atom that was assigned to true
+     */
+    void theory_str_noodler::instantiate_lazy_axioms(expr *cnt) {
+        ptr_vector<expr> terms;
+        if(!m_lazy_contains_terms.find(cnt, terms)) {
+            return;
+        }
+        m_lazy_contains_terms.remove(cnt);
+        ctx.push_trail(remove_obj_map<expr, ptr_vector<expr>>(m_lazy_contains_terms, cnt, terms));
+        for(expr* term : terms) {
+            ++m_stats.m_num_lazy_axioms;
+            if(m_util_s.str.is_replace(term)) {
+                add_replace_split_axioms(term);
+            } else {
+                add_index_of_split_axioms(term);
+            }
+        }
+    }
+
     /**
      * @brief String term @p x does not contain @p s as a substring.
      * Translates to the following theory axioms:
@@ -1457,6 +1927,11 @@ namespace smt::noodler {
      * @param x String term
      */
     void theory_str_noodler::tightest_prefix(expr* s, expr* x) {
+        // x is shared for all terms with the same first occurrence of s, add the axioms only once
+        if(axiomatized_persist_terms.contains(x))
+            return;
+        axiomatized_persist_terms.insert(x);
+
         expr_ref s1 = mk_first(s);
         expr_ref c  = mk_last(s);
         expr_ref s1c = mk_concat(s1, c);
@@ -1864,6 +2339,10 @@ namespace smt::noodler {
 
     void theory_str_noodler::block_curr_len(expr_ref len_formula) {
         STRACE("str", tout << __LINE__ << " enter " << __FUNCTION__ << std::endl;);
+        if (m_event_log) {
+            m_event_log->log(EventType::BlockingLemma, 0, m_stats.m_num_final_checks, m_word_eq_todo_rel.size(),
+                             m_word_diseq_todo_rel.size(), m_membership_todo_rel.size());
+        }
 
         bool on_screen=false;
         context& ctx = get_context();
@@ -2052,6 +2531,57 @@ namespace smt::noodler {
         return var;
     }
 
+    /**
+     * @brief Get the representative of the shape (@p kind, @p base, @p param) of a string function.
+     *
+     * Both @p base and @p param are normalized by the rewriter, so syntactically different but equivalent
+     * terms (e.g. offsets i+1 and 1+i) have the same shape. If the shape is new, its representative is
+     * created by @p mk_term.
+     *
+     * @param kind Kind of the shape (function name)
+     * @param base Base string (or the whole term)
+     * @param param Parameter of the shape (offset, searched string, ...), might be nullptr
+     * @param mk_term Function creating the representative of a new shape
+     * @param[out] is_new Whether the shape was seen for the first time
+     * @return Representative of the shape
+     */
+    expr* theory_str_noodler::get_shape(const std::string& kind, expr* base, expr* param, const std::function<expr_ref()>& mk_term, bool& is_new) {
+        expr_ref nbase(base, m);
+        m_rewrite(nbase);
+        expr_ref nparam(param, m);
+        if(param != nullptr) {
+            m_rewrite(nparam);
+        }
+        shape_key key{kind, nbase->get_id(), param != nullptr ? nparam->get_id() : UINT_MAX};
+        auto it = m_shape_terms.find(key);
+        if(it != m_shape_terms.end()) {
+            ++m_stats.m_num_shared_shapes;
+            is_new = false;
+            return it->second;
+        }
+        expr_ref term = mk_term();
+        unsigned num_pins = m_shape_pins.size();
+        m_shape_pins.push_back(nbase);
+        if(param != nullptr) {
+            m_shape_pins.push_back(nparam);
+        }
+        m_shape_pins.push_back(term);
+        m_shape_terms.emplace(key, term.get());
+        // the representative has the axioms of the shape only until the current scope is backtracked
+        ctx.push_trail(shape_trail(*this, key, m_shape_pins.size() - num_pins));
+        is_new = true;
+        return term;
+    }
+
+    /**
+     * @brief Create a fresh string variable that is shared by all terms with the shape (@p kind, @p base, @p param),
+     * see get_shape().
+     */
+    expr_ref theory_str_noodler::mk_shared_str_var(const std::string& kind, expr* base, expr* param) {
+        bool is_new = false;
+        return expr_ref(get_shape(kind, base, param, [&]() { return mk_str_var(kind); }, is_new), m);
+    }
+
     /**
     Convert equation/disaequation @p ex to the instance of Predicate. As a side effect updates mapping of
     variables (BasicTerm) to the corresponding z3 expr.
@@ -2114,12 +2644,19 @@ namespace smt::noodler {
      * @brief Check if the length formula @p len_formula is satisfiable.
      * 
      * @param len_formula Formula to be check
+     * @param state_id Solving state the formula comes from (only for the event log)
      * @return lbool Sat
      */
-    lbool theory_str_noodler::check_len_sat(expr_ref len_formula, model_ref &mod) {
+    lbool theory_str_noodler::check_len_sat(expr_ref len_formula, model_ref &mod, unsigned state_id) {
+        ++m_stats.m_num_len_checks;
+        const uint64_t started = m_event_log ? m_event_log->now() : 0;
         int_expr_solver m_int_solver(get_manager(), get_context().get_fparams());
         m_int_solver.initialize(get_context());
         auto ret = m_int_solver.check_sat(len_formula);
+        if (m_event_log) {
+            m_event_log->log_since(started, EventType::LengthCheck, state_id, m_stats.m_num_final_checks, 0, 0, 0,
+                                   static_cast<uint8_t>(ret));
+        }
         return ret;
     }
 }
@@ -13,6 +13,7 @@ Eternal glory to Yu-Fang.
 #include <map>
 #include <memory>
 #include <queue>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -33,6 +34,7 @@ Eternal glory to Yu-Fang.
 #include "formula.h"
 #include "inclusion_graph.h"
 #include "decision_procedure.h"
+#include "event_log.h"
 #include "expr_solver.h"
 #include "util.h"
 
@@ -40,9 +42,24 @@ namespace smt::noodler {
 
     class theory_str_noodler : public theory {
     protected:
+        struct stats {
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(stats)); }
+            unsigned m_num_final_checks;
+            unsigned m_num_noodles;
+            unsigned m_num_len_checks;
+            unsigned m_num_underapprox_sat;
+            unsigned m_num_shared_shapes;
+            unsigned m_num_lazy_axioms;
+            unsigned m_num_concrete_sat;
+            unsigned m_num_concrete_conflicts;
+            unsigned m_num_concrete_dropped;
+            unsigned m_num_bounded_sat;
+        };
 
         int m_scope_level = 0;
-        static bool is_over_approximation;
+        // are we inside final_check_eh() (used only for tracing)
+        bool m_in_final_check = false;
         const theory_str_noodler_params& m_params;
         th_rewriter m_rewrite;
         arith_util m_util_a;
@@ -57,6 +74,32 @@ namespace smt::noodler {
         // mapping predicates and function to variables that they substitute to
         obj_map<expr, expr*> predicate_replace;
 
+        // representatives (fresh variables or terms) of string-function shapes; the key consists of the kind
+        // of the shape and the ids of its normalized base string and parameter, see get_shape()
+        using shape_key = std::tuple<std::string, unsigned, unsigned>;
+        std::map<shape_key, expr*> m_shape_terms;
+        // keeps the keys and representatives of m_shape_terms alive
+        expr_ref_vector m_shape_pins;
+        // replace/indexof terms whose axioms for the case contains(a,s) are postponed until the
+        // contains atom (the key) becomes true
+        obj_map<expr, ptr_vector<expr>> m_lazy_contains_terms;
+        // keeps the keys and terms of m_lazy_contains_terms alive
+        expr_ref_vector m_lazy_pins;
+
+        // The axioms of a shape are deleted when the scope in which they were added is backtracked,
+        // so the shape (and its pins) is removed from m_shape_terms as well.
+        class shape_trail : public trail {
+            theory_str_noodler& th;
+            shape_key m_key;
+            unsigned m_num_pins;
+        public:
+            shape_trail(theory_str_noodler& th, const shape_key& key, unsigned num_pins): th(th), m_key(key), m_num_pins(num_pins) {}
+            void undo() override {
+                th.m_shape_terms.erase(m_key);
+                th.m_shape_pins.shrink(th.m_shape_pins.size() - m_num_pins);
+            }
+        };
+
         std::vector<app_ref> axiomatized_len_axioms;
         obj_hashtable<expr> axiomatized_terms;
         obj_hashtable<expr> axiomatized_persist_terms;
@@ -85,11 +128,19 @@ namespace smt::noodler {
         vector<expr_pair> m_word_diseq_todo_rel;
         vector<expr_pair_flag> m_membership_todo_rel;
 
+        stats m_stats;
+        // binary trace of the search (see the parameter str.event_log), opened at the first final check
+        std::unique_ptr<EventLog> m_event_log;
+        // file of m_event_log; copies of the theory created by mk_fresh() get their own file
+        std::string m_event_log_path;
+        // number of copies of the theory created by mk_fresh()
+        unsigned m_num_fresh = 0;
+
     public:
         char const * get_name() const override { return "noodler"; }
         theory_str_noodler(context& ctx, ast_manager & m, theory_str_noodler_params const & params);
         void display(std::ostream& os) const override;
-        theory *mk_fresh(context * newctx) override { return alloc(theory_str_noodler, *newctx, get_manager(), m_params); }
+        theory *mk_fresh(context * newctx) override;
         void init() override;
         theory_var mk_var(enode *n) override;
         void apply_sort_cnstr(enode* n, sort* s) override;
@@ -110,6 +161,7 @@ namespace smt::noodler {
         void init_model(model_generator& m) override;
         void finalize_model(model_generator& mg) override;
         lbool validate_unsat_core(expr_ref_vector& unsat_core) override;
+        void collect_statistics(::statistics & st) const override;
 
         void add_length_axiom(expr* n);
 
@@ -126,7 +178,7 @@ namespace smt::noodler {
         expr_ref mk_first(expr* e);
         expr_ref mk_concat(expr* e1, expr* e2);
 
-        lbool check_len_sat(expr_ref len_formula, model_ref &mod);
+        lbool check_len_sat(expr_ref len_formula, model_ref &mod, unsigned state_id = 0);
 
 
         bool has_length(expr *e) const { return m_has_length.contains(e); }
@@ -162,6 +214,22 @@ namespace smt::noodler {
 
         lbool solve_underapprox(const Formula& instance, const AutAssignment& aut_ass, const std::unordered_set<BasicTerm>& init_length_sensitive_vars);
 
+        /**
+         * @brief Decide the current assignment of string constraints (the body of final_check_eh()).
+         */
+        final_check_status final_check_core();
+
+        /**
+         * @brief Decide the constraints over variables with concrete values by plain string evaluation.
+         */
+        lbool solve_concrete();
+        bool get_concrete_value(expr* e, zstring& val, obj_map<expr, expr*>& var_lits);
+
+        /**
+         * @brief Search for a solution with words of bounded length (see str.bounded_len).
+         */
+        lbool solve_bounded(const std::set<uint32_t>& alphabet);
+
         expr_ref mk_sub(expr *a, expr *b);
         zstring print_word_term(expr * a) const;
 
@@ -174,9 +242,15 @@ namespace smt::noodler {
         void add_axiom(std::initializer_list<literal> ls);
         void handle_char_at(expr *e);
         void handle_substr(expr *e);
-        void handle_substr_int(expr *e);
+        void handle_substr_int(expr *e, const expr_ref& v);
         void handle_index_of(expr *e);
         void handle_replace(expr *e);
+        void add_replace_split_axioms(expr *r);
+        void add_index_of_split_axioms(expr *i);
+        void add_after_contains(literal cnt, expr *term);
+        void instantiate_lazy_axioms(expr *cnt);
+        expr* get_shape(const std::string& kind, expr* base, expr* param, const std::function<expr_ref()>& mk_term, bool& is_new);
+        expr_ref mk_shared_str_var(const std::string& kind, expr* base, expr* param = nullptr);
         void handle_prefix(expr *e);
         void handle_suffix(expr *e);
         void handle_not_prefix(expr *e);
@@ -695,4 +695,82 @@ namespace smt::noodler::util {
         
         return true;
     }
+
+    expr_ref len_to_expr(const LenNode * node, const std::map<BasicTerm, expr_ref>& variable_map, ast_manager &m,
+                         seq_util& m_util_s, arith_util& m_util_a, LenExprCache* cache) {
+        if(cache != nullptr) {
+            auto it = cache->find(node);
+            if(it != cache->end()) {
+                return it->second;
+            }
+        }
+
+        auto conv = [&](const LenNode* n) { return len_to_expr(n, variable_map, m, m_util_s, m_util_a, cache); };
+        expr_ref res(m);
+        switch(node->type) {
+        case LenFormulaType::LEAF:
+            if(node->atom_val.get_type() == BasicTermType::Length) {
+                res = m_util_a.mk_int(std::stoi(node->atom_val.get_name().encode()));
+            } else {
+                auto it = variable_map.find(node->atom_val);
+                if(it != variable_map.end()) { // if the variable is not found, it was introduced in the preprocessing -> create a new z3 variable
+                    res = m_util_s.str.mk_length(it->second);
+                } else {
+                    res = mk_int_var(node->atom_val.get_name().encode(), m, m_util_s, m_util_a);
+                }
+            }
+            break;
+
+        case LenFormulaType::PLUS: {
+            assert(node->succ.size() >= 2);
+            res = conv(node->succ[0]);
+            for(size_t i = 1; i < node->succ.size(); i++) {
+                res = m_util_a.mk_add(res, conv(node->succ[i]));
+            }
+            break;
+        }
+
+        case LenFormulaType::EQ: {
+            assert(node->succ.size() == 2);
+            expr_ref left = conv(node->succ[0]);
+            expr_ref right = conv(node->succ[1]);
+            res = m_util_a.mk_eq(left, right);
+            break;
+        }
+
+        case LenFormulaType::LEQ: {
+            assert(node->succ.size() == 2);
+            expr_ref left = conv(node->succ[0]);
+            expr_ref right = conv(node->succ[1]);
+            res = m_util_a.mk_le(left, right);
+            break;
+        }
+
+        case LenFormulaType::NOT: {
+            assert(node->succ.size() == 1);
+            res = m.mk_not(conv(node->succ[0]));
+            break;
+        }
+
+        case LenFormulaType::AND: {
+            if(node->succ.size() == 0) {
+                res = m.mk_true();
+                break;
+            }
+            res = conv(node->succ[0]);
+            for(size_t i = 1; i < node->succ.size(); i++) {
+                res = m.mk_and(res, conv(node->succ[i]));
+            }
+            break;
+        }
+
+        default:
+            UNREACHABLE();
+        }
+
+        if(cache != nullptr) {
+            cache->emplace(node, res);
+        }
+        return res;
+    }
 }
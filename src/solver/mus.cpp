@@ -18,10 +18,14 @@ Notes:
 
 --*/
 
+#include "util/scoped_ptr_vector.h"
+#include "util/scoped_timer.h"
+#include "util/thread_pool.h"
 #include "solver/solver.h"
 #include "solver/mus.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "ast/ast_translation.h"
 #include "model/model_evaluator.h"
 
 
@@ -38,6 +42,8 @@ struct mus::imp {
     expr_ref_vector          m_soft;
     vector<rational>         m_weights;
     rational                 m_weight;
+    unsigned                 m_num_threads = 1;
+    unsigned                 m_budget = 0;
 
     imp(solver& s): 
         m_solver(s), m(s.get_manager()), m_lit2expr(m),  m_assumptions(m), m_soft(m)
@@ -74,9 +80,215 @@ struct mus::imp {
             mus.push_back(m_lit2expr.back());
             return l_true;
         }
+        if (m_num_threads > 1 && m_lit2expr.size() > 2)
+            return get_mus_par(mus);
         return get_mus1(mus);
     }
 
+    /**
+       A copy of the solver over its own ast_manager, used by get_mus_par.
+       Soft constraints are identified by their index in m_lit2expr.
+    */
+    struct worker {
+        ast_manager&            m;
+        ref<solver>             s;
+        expr_ref_vector         soft, nsoft, assumptions, asms;
+        obj_map<expr, unsigned> soft2idx;
+        lbool                   result = l_undef;
+        unsigned_vector         core;
+        bool                    core_has_neg = false;
+        worker(ast_manager& m): m(m), soft(m), nsoft(m), assumptions(m), asms(m) {}
+    };
+
+    /**
+       Cancel the workers of get_mus_par when the time budget is used up.
+    */
+    struct budget_eh : public event_handler {
+        scoped_ptr_vector<ast_manager>& m_managers;
+        budget_eh(scoped_ptr_vector<ast_manager>& managers): m_managers(managers) {}
+        void operator()(event_handler_caller_t caller_id) override {
+            m_caller_id = caller_id;
+            for (ast_manager* wm : m_managers)
+                wm->limit().cancel();
+        }
+    };
+
+    /**
+       Parallel version of get_mus1. In each round every worker checks the
+       candidates without a group of them. Candidates whose deletion is
+       satisfiable belong to every sub-core and are all added to the mus.
+       The unsatisfiable deletion leaving the fewest candidates is applied.
+       Groups are halved when a round removes no candidates.
+       When a worker does not decide its check, e.g., because the time budget
+       is used up, the remaining candidates are kept and the core found so far
+       is returned unminimized.
+    */
+    lbool get_mus_par(expr_ref_vector& mus) {
+        unsigned num_workers = m_num_threads;
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_ptr_vector<worker> workers;
+        scoped_limits sl(m.limit());
+        try {
+            for (unsigned i = 0; i < num_workers; ++i) {
+                ast_manager* wm = alloc(ast_manager, m, true);
+                managers.push_back(wm);
+                worker* w = alloc(worker, *wm);
+                workers.push_back(w);
+                w->s = m_solver.translate(*wm, m_solver.get_params());
+                ast_translation tr(m, *wm);
+                for (unsigned j = 0; j < m_lit2expr.size(); ++j) {
+                    w->soft.push_back(tr(m_lit2expr.get(j)));
+                    w->nsoft.push_back(mk_not(*wm, w->soft.get(j)));
+                    w->soft2idx.insert(w->soft.get(j), j);
+                }
+                w->assumptions.append(tr(m_assumptions));
+                sl.push_child(&wm->limit());
+            }
+        }
+        catch (z3_exception& ex) {
+            IF_VERBOSE(1, verbose_stream() << "(mus sequential: " << ex.msg() << ")\n";);
+            return get_mus1(mus);
+        }
+
+        budget_eh eh(managers);
+        scoped_ptr<scoped_timer> timer;
+        if (m_budget > 0)
+            timer = alloc(scoped_timer, m_budget, &eh);
+
+        unsigned_vector unknown, necessary, reduced, core_mus;
+        for (unsigned j = 0; j < m_lit2expr.size(); ++j)
+            unknown.push_back(j);
+        bool_vector in_unknown(m_lit2expr.size(), false);
+        unsigned group_size = std::max(1u, unknown.size() / (2 * num_workers));
+        auto group_end = [&](unsigned i) { return unknown.size() - i * group_size; };
+        auto group_begin = [&](unsigned i) { return unknown.size() > (i + 1) * group_size ? unknown.size() - (i + 1) * group_size : 0; };
+
+        while (!unknown.empty()) {
+            if (!m.inc())
+                return l_undef;
+            group_size = std::min(group_size, std::max(1u, unknown.size() / num_workers));
+            unsigned num_groups = std::min(num_workers, (unknown.size() + group_size - 1) / group_size);
+            IF_VERBOSE(12, verbose_stream() << "(mus reducing core: " << unknown.size() << " new core: " << core_mus.size() 
+                       << " groups: " << num_groups << " group-size: " << group_size << ")\n";);
+
+            // tasks skipped after a cancellation keep the result l_undef.
+            for (worker* w : workers)
+                w->result = l_undef;
+            thread_pool::run(num_groups, [&](unsigned i) {
+                worker& w = *workers[i];
+                unsigned b = group_begin(i), e = group_end(i);
+                w.asms.reset();
+                w.asms.append(w.assumptions);
+                for (unsigned j : core_mus)
+                    w.asms.push_back(w.soft.get(j));
+                for (unsigned j = 0; j < unknown.size(); ++j)
+                    if (j < b || j >= e)
+                        w.asms.push_back(w.soft.get(unknown[j]));
+                if (e - b == 1)
+                    w.asms.push_back(w.nsoft.get(unknown[b]));
+                w.result = w.s->check_sat(w.asms);
+                w.core.reset();
+                w.core_has_neg = false;
+                if (w.result == l_false) {
+                    expr_ref_vector core(w.m);
+                    w.s->get_unsat_core(core);
+                    unsigned idx;
+                    for (expr* c : core) {
+                        if (w.soft2idx.find(c, idx))
+                            w.core.push_back(idx);
+                        else if (e - b == 1 && c == w.nsoft.get(unknown[b]))
+                            w.core_has_neg = true;
+                    }
+                }
+            }, &m.limit());
+
+            necessary.reset();
+            if (!m.inc())
+                return l_undef;
+            for (unsigned j : unknown)
+                in_unknown[j] = true;
+            unsigned best = UINT_MAX, best_size = UINT_MAX;
+            bool split = false, aborted = false;
+            for (unsigned i = 0; i < num_groups; ++i) {
+                worker& w = *workers[i];
+                unsigned b = group_begin(i), e = group_end(i);
+                switch (w.result) {
+                case l_true:
+                    update_model(w);
+                    if (e - b == 1)
+                        necessary.push_back(unknown[b]);
+                    else
+                        split = true;
+                    break;
+                case l_undef:
+                    aborted = true;
+                    break;
+                case l_false: {
+                    unsigned sz = 0;
+                    if (w.core_has_neg)
+                        sz = unknown.size() - 1;
+                    else 
+                        for (unsigned j : w.core)
+                            sz += in_unknown[j];
+                    if (sz < best_size)
+                        best = i, best_size = sz;
+                    break;
+                }
+                }
+            }
+
+            if (aborted) {
+                IF_VERBOSE(12, verbose_stream() << "(mus aborted, unminimized core: " << unknown.size() + core_mus.size() << ")\n";);
+                core_mus.append(unknown);
+                break;
+            }
+
+            if (best != UINT_MAX) {
+                worker& w = *workers[best];
+                unsigned b = group_begin(best);
+                reduced.reset();
+                if (w.core_has_neg) {
+                    for (unsigned j = 0; j < unknown.size(); ++j)
+                        if (j != b)
+                            reduced.push_back(unknown[j]);
+                }
+                else {
+                    for (unsigned j : w.core)
+                        if (in_unknown[j])
+                            reduced.push_back(j);
+                }
+                for (unsigned j : unknown)
+                    in_unknown[j] = false;
+                unknown.reset();
+                unknown.append(reduced);
+            }
+            else {
+                for (unsigned j : unknown)
+                    in_unknown[j] = false;
+                if (split && group_size > 1)
+                    group_size /= 2;
+            }
+            for (unsigned j : necessary) {
+                unknown.erase(j);
+                core_mus.push_back(j);
+            }
+        }
+        for (unsigned j : core_mus)
+            mus.push_back(m_lit2expr.get(j));
+        return l_true;
+    }
+
+    void update_model(worker& w) {
+        if (m_soft.empty()) return;
+        model_ref wmdl, mdl;
+        w.s->get_model(wmdl);
+        if (!wmdl)
+            return;
+        ast_translation tr(w.m, m);
+        mdl = wmdl->translate(tr);
+        update_model(mdl);
+    }
+
     lbool get_mus1(expr_ref_vector& mus) {
         ptr_vector<expr> unknown(m_lit2expr.size(), m_lit2expr.data());
         expr_ref_vector core_exprs(m);
@@ -327,8 +539,11 @@ struct mus::imp {
     void update_model() {
         if (m_soft.empty()) return;
         model_ref mdl;
-        expr_ref tmp(m);
         m_solver.get_model(mdl);
+        update_model(mdl);
+    }
+
+    void update_model(model_ref& mdl) {
         rational w;
         for (unsigned i = 0; i < m_soft.size(); ++i) {
             if (!mdl->is_true(m_soft.get(i))) {
@@ -380,3 +595,11 @@ void mus::set_soft(unsigned sz, expr* const* soft, rational const* weights) {
 rational mus::get_best_model(model_ref& mdl) {
     return m_imp->get_best_model(mdl);
 }
+
+void mus::set_num_threads(unsigned n) {
+    m_imp->m_num_threads = std::max(1u, n);
+}
+
+void mus::set_budget(unsigned ms) {
+    m_imp->m_budget = ms;
+}
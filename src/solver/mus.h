@@ -59,6 +59,18 @@ class mus {
     void set_soft(unsigned sz, expr* const* soft, rational const* weights);
 
     rational get_best_model(model_ref& mdl);
+
+    /**
+       Use n translated copies of the solver to test deletions of
+       soft constraints in parallel.
+    */
+    void set_num_threads(unsigned n);
+
+    /**
+       Time budget in milliseconds for the parallel minimization, 0 for no
+       budget. When it is used up, the core found so far is returned.
+    */
+    void set_budget(unsigned ms);
     
 };
 
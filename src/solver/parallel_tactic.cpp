@@ -29,6 +29,7 @@ Notes:
 --*/
 
 #include "util/scoped_ptr_vector.h"
+#include "util/thread_pool.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/ast_translation.h"
@@ -728,11 +729,7 @@ private:
 
     lbool solve(model_ref& mdl) {        
         add_branches(1);
-        vector<std::thread> threads;
-        for (unsigned i = 0; i < m_num_threads; ++i) 
-            threads.push_back(std::thread([this]() { run_solver(); }));
-        for (std::thread& t : threads) 
-            t.join();
+        thread_pool::run(m_num_threads, [this](unsigned) { run_solver(); }, &m_manager.limit());
         m_queue.stats(m_stats);
         m_manager.limit().reset_cancel();
         if (m_exn_code == -1) 
@@ -31,6 +31,7 @@ Notes:
 #include "tactic/smtlogics/qfaufbv_tactic.h"
 #include "tactic/smtlogics/qfufbv_tactic.h"
 #include "tactic/smtlogics/qfidl_tactic.h"
+#include "tactic/smtlogics/qfs_tactic.h"
 #include "tactic/smtlogics/nra_tactic.h"
 #include "tactic/portfolio/default_tactic.h"
 #include "tactic/fd_solver/fd_solver.h"
@@ -92,6 +93,10 @@ tactic * mk_tactic_for_logic(ast_manager & m, params_ref const & p, symbol const
         return mk_ufbv_tactic(m, p);
     else if (logic=="BV")
         return mk_ufbv_tactic(m, p);
+    else if (logic=="QF_S")
+        return mk_qfs_tactic(m, p);
+    else if (logic=="QF_SLIA")
+        return mk_qfslia_tactic(m, p);
     else if (logic=="QF_FP")
         return mk_qffp_tactic(m, p);
     else if (logic == "QF_FPBV" || logic == "QF_BVFP")
@@ -0,0 +1,66 @@
+/*++
+Module Name:
+
+    qfs_tactic.cpp
+
+Abstract:
+
+    Tactics for QF_S and QF_SLIA benchmarks.
+
+Notes:
+
+    Preprocessing at the level of the goal is done once, while the same
+    reasoning inside the string solver would be repeated in every final check.
+
+--*/
+#include "tactic/tactical.h"
+#include "tactic/core/simplify_tactic.h"
+#include "tactic/core/propagate_values_tactic.h"
+#include "tactic/core/solve_eqs_tactic.h"
+#include "tactic/core/elim_uncnstr_tactic.h"
+#include "tactic/core/ctx_simplify_tactic.h"
+#include "tactic/arith/probe_arith.h"
+#include "tactic/smtlogics/qflia_tactic.h"
+#include "tactic/smtlogics/smt_tactic.h"
+#include "tactic/smtlogics/qfs_tactic.h"
+
+/**
+   \brief Common preprocessing of string goals. The simplifier uses the sequence
+   rewriter, so concatenations of constants are folded and constant string
+   functions are evaluated; solve_eqs substitutes string variables defined by
+   equations x = t, which also propagates constant concatenations to the uses of x.
+*/
+static tactic * mk_qfs_preamble(ast_manager & m, params_ref const & p) {
+    params_ref main_p;
+    main_p.set_bool("elim_and", true);
+    main_p.set_bool("som", true);
+
+    params_ref ctx_simp_p;
+    ctx_simp_p.set_uint("max_depth", 30);
+    ctx_simp_p.set_uint("max_steps", 5000000);
+
+    return and_then(using_params(mk_simplify_tactic(m, p), main_p),
+                    mk_propagate_values_tactic(m, p),
+                    using_params(mk_ctx_simplify_tactic(m, p), ctx_simp_p),
+                    mk_solve_eqs_tactic(m, p),
+                    mk_elim_uncnstr_tactic(m, p),
+                    using_params(mk_simplify_tactic(m, p), main_p));
+}
+
+tactic * mk_qfs_tactic(ast_manager & m, params_ref const & p) {
+    tactic * st = and_then(mk_qfs_preamble(m, p),
+                           mk_smt_tactic(m, p));
+    st->updt_params(p);
+    return st;
+}
+
+tactic * mk_qfslia_tactic(ast_manager & m, params_ref const & p) {
+    // if the preprocessing eliminated all string constraints (e.g. only lengths of
+    // solved variables were left), the rest is solved by the QF_LIA strategy
+    tactic * st = and_then(mk_qfs_preamble(m, p),
+                           cond(mk_is_qflia_probe(),
+                                mk_qflia_tactic(m, p),
+                                mk_smt_tactic(m, p)));
+    st->updt_params(p);
+    return st;
+}
@@ -0,0 +1,31 @@
+/*++
+Module Name:
+
+    qfs_tactic.h
+
+Abstract:
+
+    Tactics for QF_S and QF_SLIA benchmarks.
+
+Notes:
+
+    The tactics preprocess the goal (simplification using the sequence rewriter,
+    propagation of values, solving equations and elimination of unconstrained
+    variables) and hand the result to the SMT core. The string solver of
+    the core is selected by smt.string_solver (e.g. noodler).
+
+--*/
+#pragma once
+
+#include "util/params.h"
+class ast_manager;
+class tactic;
+
+tactic * mk_qfs_tactic(ast_manager & m, params_ref const & p = params_ref());
+
+tactic * mk_qfslia_tactic(ast_manager & m, params_ref const & p = params_ref());
+
+/*
+  ADD_TACTIC("qfs", "builtin strategy for solving QF_S problems.", "mk_qfs_tactic(m, p)")
+  ADD_TACTIC("qfslia", "builtin strategy for solving QF_SLIA problems.", "mk_qfslia_tactic(m, p)")
+*/
@@ -19,9 +19,10 @@ Notes:
 #include "util/scoped_timer.h"
 #include "util/cancel_eh.h"
 #include "util/scoped_ptr_vector.h"
+#include "util/thread_pool.h"
 #include "tactic/tactical.h"
 #ifndef SINGLE_THREAD
-#include <thread>
+#include <mutex>
 #endif
 #include <vector>
 
@@ -547,14 +548,7 @@ public:
             }
         };
 
-        vector<std::thread> threads(sz);
-
-        for (unsigned i = 0; i < sz; ++i) {
-            threads[i] = std::thread([&, i]() { worker_thread(i); });
-        }
-        for (unsigned i = 0; i < sz; ++i) {
-            threads[i].join();
-        }
+        thread_pool::run(sz, [&](unsigned i) { worker_thread(i); }, &m.limit());
         
         if (finished_id == UINT_MAX) {
             switch (ex_kind) {
@@ -773,13 +767,7 @@ public:
             if (m.has_trace_stream())
                 throw default_exception("threads and trace are incompatible");
 
-            vector<std::thread> threads(r1_size);
-            for (unsigned i = 0; i < r1_size; ++i) {
-                threads[i] = std::thread([&, i]() { worker_thread(i); });
-            }
-            for (unsigned i = 0; i < r1_size; ++i) {
-                threads[i].join();
-            }
+            thread_pool::run(r1_size, [&](unsigned i) { worker_thread(i); }, &m.limit());
             
             if (failed) {
                 switch (ex_kind) {
@@ -248,6 +248,11 @@ int main(int argc, char ** argv) {
     TST(theory_pb);
     TST(simplex);
     TST(sat_user_scope);
+    TST(sat_assumption_reuse);
+    TST(sat_clause_cache);
+    TST(sat_parallel);
+    TST(sat_ddfw);
+    TST(mus);
     TST_ARGV(ddnf);
     TST(ddnf1);
     TST(model_evaluator);
@@ -260,6 +265,7 @@ int main(int argc, char ** argv) {
     TST(pdd);
     TST(pdd_solver);
     TST(scoped_timer);
+    TST(thread_pool);
     TST(solver_pool);
     //TST_ARGV(hs);
     TST(finder);
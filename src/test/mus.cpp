@@ -0,0 +1,116 @@
+/*++
+
+Module Name:
+
+    mus.cpp
+
+Abstract:
+
+    Test that parallel core minimization finds the same minimal core as
+    the sequential one, for the sat solver and for the generic solver mus.
+
+--*/
+
+#include "sat/sat_solver.h"
+#include "solver/solver.h"
+#include "solver/mus.h"
+#include "smt/smt_solver.h"
+#include "ast/reg_decl_plugins.h"
+#include "util/util.h"
+#include <algorithm>
+#include <iostream>
+
+// the assumptions 1, 2, 4 form the only minimal core. The clauses over the other
+// assumptions imply the core clause, so conflicts found during propagation can
+// involve more assumptions than the minimal core.
+static unsigned const num_asms = 8;
+static unsigned const mus_asms[3] = { 1, 2, 4 };
+
+static sat::literal_vector sat_core(unsigned num_threads) {
+    params_ref p;
+    p.set_bool("core.minimize", true);
+    p.set_uint("core.minimize_threads", num_threads);
+    reslimit lim;
+    sat::solver s(p, lim);
+    for (unsigned v = 0; v <= num_asms; ++v)
+        s.mk_var(false, true);
+    auto a = [&](unsigned i) { return sat::literal(i, false); };
+    sat::literal x(num_asms, false);
+    sat::literal_vector cls;
+    auto mk_clause = [&](sat::literal l) {
+        cls.reset();
+        for (unsigned i : mus_asms)
+            cls.push_back(~a(i));
+        cls.push_back(l);
+        s.mk_clause(cls);
+    };
+    for (unsigned i : { 0u, 3u, 5u, 6u, 7u })
+        mk_clause(~a(i));
+    mk_clause(x);
+    mk_clause(~x);
+    sat::literal_vector asms;
+    for (unsigned i = 0; i < num_asms; ++i)
+        asms.push_back(a(i));
+    ENSURE(s.check(asms.size(), asms.data()) == l_false);
+    sat::literal_vector core(s.get_core());
+    std::sort(core.begin(), core.end());
+    return core;
+}
+
+static void tst_sat_mus() {
+    sat::literal_vector core1 = sat_core(1);
+    sat::literal_vector core4 = sat_core(4);
+    std::cout << "sat mus1: " << core1 << " mus_par: " << core4 << "\n";
+    ENSURE(core1.size() == 3);
+    for (unsigned i = 0; i < 3; ++i)
+        ENSURE(core1[i] == sat::literal(mus_asms[i], false));
+    ENSURE(core1 == core4);
+}
+
+static lbool solver_mus(ast_manager& m, unsigned num_threads, unsigned budget, expr_ref_vector& core) {
+    params_ref p;
+    ref<solver> s = mk_smt_solver(m, p, symbol::null);
+    expr_ref_vector a(m);
+    for (unsigned i = 0; i < num_asms; ++i)
+        a.push_back(m.mk_const(symbol(std::string("a") + std::to_string(i)), m.mk_bool_sort()));
+    expr_ref x(m.mk_const(symbol("x"), m.mk_bool_sort()), m);
+    expr_ref mus_fml(m.mk_and(a.get(1), a.get(2), a.get(4)), m);
+    for (unsigned i : { 0u, 3u, 5u, 6u, 7u })
+        s->assert_expr(m.mk_not(m.mk_and(a.get(i), mus_fml)));
+    s->assert_expr(m.mk_implies(mus_fml, x));
+    s->assert_expr(m.mk_implies(mus_fml, m.mk_not(x)));
+    ENSURE(s->check_sat(a) == l_false);
+
+    ::mus ms(*s);
+    ms.add_soft(a.size(), a.data());
+    ms.set_num_threads(num_threads);
+    ms.set_budget(budget);
+    core.reset();
+    lbool r = ms.get_mus(core);
+    // the result is a core whether or not it was minimized.
+    ENSURE(r != l_true || s->check_sat(core) == l_false);
+    return r;
+}
+
+static void tst_solver_mus() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector core1(m), core4(m);
+    ENSURE(solver_mus(m, 1, 0, core1) == l_true);
+    ENSURE(solver_mus(m, 4, 0, core4) == l_true);
+    std::cout << "solver mus1: " << core1 << " mus_par: " << core4 << "\n";
+    ENSURE(core1.size() == 3);
+    ENSURE(core4.size() == 3);
+    for (expr* e : core1)
+        ENSURE(core4.contains(e));
+
+    // a budget that is used up before the first round returns the unminimized core.
+    expr_ref_vector core(m);
+    ENSURE(solver_mus(m, 4, 1, core) == l_true);
+    ENSURE(core.size() >= 3);
+}
+
+void tst_mus() {
+    tst_sat_mus();
+    tst_solver_mus();
+}
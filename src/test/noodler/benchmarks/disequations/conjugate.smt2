@@ -0,0 +1,6 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(assert (not (= (str.++ x "a") (str.++ "a" x))))
+(assert (str.in_re x (re.* (re.union (str.to_re "a") (str.to_re "b")))))
+(check-sat)
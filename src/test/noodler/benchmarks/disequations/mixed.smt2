@@ -0,0 +1,11 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(declare-fun z () String)
+(assert (= (str.++ x y) (str.++ z "ab")))
+(assert (not (= x z)))
+(assert (not (= y "ab")))
+(assert (not (= x "")))
+(assert (str.in_re z (re.* (str.to_re "ab"))))
+(check-sat)
@@ -0,0 +1,9 @@
+(set-logic QF_SLIA)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(assert (= (str.++ x y) (str.++ y x)))
+(assert (= (str.len x) 3))
+(assert (= (str.len y) 5))
+(assert (str.in_re x (re.* (str.to_re "a"))))
+(check-sat)
@@ -0,0 +1,10 @@
+(set-logic QF_SLIA)
+(set-info :status unsat)
+(declare-fun x () String)
+(declare-fun y () String)
+(declare-fun z () String)
+(assert (= z (str.++ x y)))
+(assert (= (str.len x) (* 2 (str.len y))))
+(assert (= (str.len z) 9))
+(assert (str.in_re z (re.* (str.to_re "ab"))))
+(check-sat)
@@ -0,0 +1,12 @@
+(set-logic QF_SLIA)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(declare-fun u () String)
+(declare-fun v () String)
+(assert (= (str.++ x "c" y) (str.++ u v)))
+(assert (= (+ (str.len x) (str.len y)) (+ (str.len u) 3)))
+(assert (> (str.len v) (str.len u)))
+(assert (str.in_re u (re.+ (re.union (str.to_re "a") (str.to_re "b")))))
+(assert (str.in_re y (re.* (str.to_re "b"))))
+(check-sat)
@@ -0,0 +1,8 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(assert (str.in_re x (re.comp (re.* (str.to_re "a")))))
+(assert (str.in_re x (re.union (re.* (str.to_re "a")) (re.+ (str.to_re "b")))))
+(assert (= (str.++ x "a") (str.++ "b" y)))
+(check-sat)
@@ -0,0 +1,8 @@
+(set-logic QF_S)
+(set-info :status unsat)
+(declare-fun x () String)
+(declare-fun y () String)
+(assert (= x (str.++ y y)))
+(assert (str.in_re x (re.++ (re.* (str.to_re "a")) (str.to_re "b"))))
+(assert (str.in_re y (re.++ (re.* (str.to_re "b")) (str.to_re "a"))))
+(check-sat)
@@ -0,0 +1,6 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(assert (str.in_re x (re.* (str.to_re "ab"))))
+(assert (str.in_re x (re.++ (re.* (re.union (str.to_re "a") (str.to_re "b"))) (str.to_re "bab"))))
+(check-sat)
@@ -0,0 +1,7 @@
+(set-logic QF_SLIA)
+(set-info :status sat)
+(declare-fun x () String)
+(assert (= (str.indexof x "b" 0) 2))
+(assert (str.in_re x (re.++ (re.* (str.to_re "a")) (re.* (str.to_re "b")))))
+(assert (<= (str.len x) 4))
+(check-sat)
@@ -0,0 +1,8 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(assert (= y (str.replace x "ab" "c")))
+(assert (= x "aabb"))
+(assert (= y "acb"))
+(check-sat)
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Run the curated noodler benchmark families and compare them against a baseline.
+
+Every *.smt2 file in a family directory (word_equations, regex, length,
+disequations, replace_indexof) is solved by z3 with the noodler string solver.
+For each benchmark we record the answer, wall time, peak RSS of the solver
+process and the noodler statistics (final-check rounds, noodles explored).
+Results are written as JSON; if a baseline is given, the run is compared
+against it and the script exits with a non-zero code on a regression.
+
+Typical use (from the build directory):
+
+    python3 ../src/test/noodler/benchmarks/run_benchmarks.py --z3 ./z3 \
+        --output bench-noodler.json
+
+    # record the current numbers as the new baseline
+    python3 ../src/test/noodler/benchmarks/run_benchmarks.py --z3 ./z3 --save-baseline
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import signal
+import subprocess
+import sys
+import threading
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+FAMILIES = ["word_equations", "regex", "length", "disequations", "replace_indexof"]
+DEFAULT_BASELINE = os.path.join(BENCH_DIR, "baseline.json")
+DEFAULT_OPTIONS = ["smt.string_solver=noodler"]
+
+# z3 prints statistics keys with dashes instead of spaces (see theory_str_noodler::collect_statistics)
+STAT_KEYS = {
+    "final_checks": "str-final-checks",
+    "noodles": "str-noodles",
+    "len_checks": "str-length-checks",
+}
+STAT_RE = re.compile(r":([\w.-]+)\s+([0-9.]+)")
+STATUS_RE = re.compile(r"\(set-info\s+:status\s+(sat|unsat|unknown)\)")
+
+
+def expected_status(path):
+    with open(path) as f:
+        m = STATUS_RE.search(f.read())
+    return m.group(1) if m else "unknown"
+
+
+def run_once(z3, path, options, timeout):
+    """Run z3 on a single file; returns (answer, wall time [s], peak RSS [kB], statistics)."""
+    cmd = [z3, "-st", "-T:%d" % timeout] + options + [path]
+    start = time.monotonic()
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    # -T is handled by z3 itself, the timer is only a safety net for a stuck process
+    killer = threading.Timer(timeout + 5, lambda: proc.send_signal(signal.SIGKILL))
+    killer.start()
+    out = proc.stdout.read().decode(errors="replace")
+    _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.monotonic() - start
+    killer.cancel()
+    proc.returncode = status  # already reaped by wait4
+
+    lines = [l.strip() for l in out.splitlines() if l.strip()]
+    answer = lines[0] if lines and lines[0] in ("sat", "unsat", "unknown") else "error"
+    if answer == "unknown" and wall >= timeout:
+        answer = "timeout"
+    stats = {k: float(v) for k, v in STAT_RE.findall(out)}
+    # ru_maxrss is in kilobytes on Linux
+    return answer, wall, rusage.ru_maxrss, stats
+
+
+def run_benchmark(z3, family, path, options, timeout, repeat):
+    times = []
+    answer, rss, stats = None, 0, {}
+    for _ in range(repeat):
+        answer, wall, rss_run, stats = run_once(z3, path, options, timeout)
+        times.append(wall)
+        rss = max(rss, rss_run)
+        if answer in ("timeout", "error"):
+            break
+    times.sort()
+    result = {
+        "family": family,
+        "name": os.path.splitext(os.path.basename(path))[0],
+        "expected": expected_status(path),
+        "answer": answer,
+        "time": round(times[len(times) // 2], 4),
+        "peak_rss_kb": rss,
+    }
+    for key, z3_key in STAT_KEYS.items():
+        result[key] = int(stats.get(z3_key, 0))
+    return result
+
+
+def collect_files(families):
+    files = []
+    for family in families:
+        fdir = os.path.join(BENCH_DIR, family)
+        if not os.path.isdir(fdir):
+            sys.exit("unknown benchmark family: " + family)
+        for name in sorted(os.listdir(fdir)):
+            if name.endswith(".smt2"):
+                files.append((family, os.path.join(fdir, name)))
+    return files
+
+
+def compare(results, baseline, args):
+    """Compare results with the baseline; returns the list of regressions (as strings)."""
+    base = {(r["family"], r["name"]): r for r in baseline["results"]}
+    regressions = []
+    for r in results:
+        key = (r["family"], r["name"])
+        ident = "%s/%s" % key
+        b = base.get(key)
+        if b is None:
+            print("  new benchmark (not in baseline): " + ident)
+            continue
+        if r["answer"] != b["answer"]:
+            regressions.append("%s: answer %s (baseline %s)" % (ident, r["answer"], b["answer"]))
+        if r["time"] > b["time"] * (1 + args.time_tolerance) and r["time"] - b["time"] > args.min_time_diff:
+            regressions.append("%s: time %.3fs (baseline %.3fs)" % (ident, r["time"], b["time"]))
+        if r["peak_rss_kb"] > b["peak_rss_kb"] * (1 + args.mem_tolerance):
+            regressions.append("%s: peak RSS %d kB (baseline %d kB)" % (ident, r["peak_rss_kb"], b["peak_rss_kb"]))
+        for key_stat in ("noodles", "final_checks"):
+            if r[key_stat] > b.get(key_stat, 0) * (1 + args.count_tolerance):
+                regressions.append("%s: %s %d (baseline %d)" % (ident, key_stat, r[key_stat], b.get(key_stat, 0)))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--z3", default="z3", help="path to the z3 binary")
+    parser.add_argument("--families", nargs="*", default=FAMILIES, help="benchmark families to run")
+    parser.add_argument("--timeout", type=int, default=60, help="timeout per benchmark in seconds")
+    parser.add_argument("--repeat", type=int, default=3, help="number of runs per benchmark (median time is taken)")
+    parser.add_argument("--option", action="append", dest="options", default=[],
+                        help="additional z3 option (e.g. smt.str.underapprox=true), may be repeated")
+    parser.add_argument("--output", help="write the results as JSON to this file")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline JSON file to compare against")
+    parser.add_argument("--save-baseline", action="store_true", help="store the results as the new baseline")
+    parser.add_argument("--time-tolerance", type=float, default=0.25, help="allowed relative slowdown")
+    parser.add_argument("--min-time-diff", type=float, default=0.05, help="ignore slowdowns below this many seconds")
+    parser.add_argument("--mem-tolerance", type=float, default=0.2, help="allowed relative growth of peak RSS")
+    parser.add_argument("--count-tolerance", type=float, default=0.0,
+                        help="allowed relative growth of the number of noodles and final checks")
+    args = parser.parse_args()
+
+    options = DEFAULT_OPTIONS + args.options
+    results = []
+    for family, path in collect_files(args.families):
+        r = run_benchmark(args.z3, family, path, options, args.timeout, args.repeat)
+        mark = "" if r["answer"] == r["expected"] or r["expected"] == "unknown" else "  <-- expected " + r["expected"]
+        print("%-16s %-20s %-8s %8.3fs %8d kB  noodles: %-6d final checks: %d%s" % (
+            family, r["name"], r["answer"], r["time"], r["peak_rss_kb"], r["noodles"], r["final_checks"], mark))
+        results.append(r)
+
+    report = {
+        "meta": {
+            "z3": os.path.abspath(args.z3) if os.path.exists(args.z3) else args.z3,
+            "options": options,
+            "host": platform.node(),
+            "machine": platform.machine(),
+            "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "repeat": args.repeat,
+            "timeout": args.timeout,
+        },
+        "results": results,
+    }
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent=2)
+
+    # a wrong answer is always an error, regardless of the baseline
+    wrong = [r for r in results if r["answer"] in ("sat", "unsat") and r["expected"] in ("sat", "unsat")
+             and r["answer"] != r["expected"]]
+
+    if args.save_baseline:
+        if wrong:
+            sys.exit("refusing to store a baseline with wrong answers")
+        with open(args.baseline, "w") as f:
+            json.dump(report, f, indent=2)
+        print("baseline stored in " + args.baseline)
+        return 0
+
+    regressions = ["%s/%s: wrong answer %s" % (r["family"], r["name"], r["answer"]) for r in wrong]
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            regressions += compare(results, json.load(f), args)
+    else:
+        print("no baseline found at %s (use --save-baseline to create it)" % args.baseline)
+
+    if regressions:
+        print("\nregressions:")
+        for reg in regressions:
+            print("  " + reg)
+        return 1
+    print("\nno regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
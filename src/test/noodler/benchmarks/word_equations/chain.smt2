@@ -0,0 +1,12 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x1 () String)
+(declare-fun x2 () String)
+(declare-fun x3 () String)
+(declare-fun x4 () String)
+(declare-fun x5 () String)
+(assert (= (str.++ x1 "a" x2) (str.++ x2 "a" x1)))
+(assert (= (str.++ x2 x3) (str.++ x3 "b" x4)))
+(assert (= (str.++ x4 x5) (str.++ x5 x4)))
+(assert (str.in_re x3 (re.* (str.to_re "ba"))))
+(check-sat)
@@ -0,0 +1,8 @@
+(set-logic QF_S)
+(set-info :status unsat)
+(declare-fun x () String)
+(declare-fun y () String)
+(assert (= (str.++ x y) (str.++ y x)))
+(assert (str.in_re x (re.+ (str.to_re "a"))))
+(assert (str.in_re y (re.+ (str.to_re "b"))))
+(check-sat)
@@ -0,0 +1,9 @@
+(set-logic QF_S)
+(set-info :status sat)
+(declare-fun x () String)
+(declare-fun y () String)
+(declare-fun z () String)
+(assert (= (str.++ x y z) (str.++ z y x)))
+(assert (str.in_re x (re.+ (str.to_re "ab"))))
+(assert (str.in_re z (re.* (re.union (str.to_re "a") (str.to_re "b")))))
+(check-sat)
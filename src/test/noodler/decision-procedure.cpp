@@ -1,6 +1,9 @@
 #include <iostream>
 #include <algorithm>
 #include <utility>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -261,4 +264,40 @@ TEST_CASE("Decision Procedure", "[noodler]") {
         proc.init_computation();
         CHECK(proc.compute_next_solution());
     }
+
+    SECTION("event-log", "[noodler]") {
+        const std::string path = (std::filesystem::temp_directory_path() / "noodler-test.evt").string();
+        {
+            EventLog log(path);
+            REQUIRE(log.is_open());
+            Formula equalities;
+            equalities.add_predicate(create_equality("xy", "zu"));
+            AutAssignment init_ass;
+            init_ass[get_var('x')] = regex_to_nfa("a*");
+            init_ass[get_var('y')] = regex_to_nfa("a*");
+            init_ass[get_var('z')] = regex_to_nfa("a*");
+            init_ass[get_var('u')] = regex_to_nfa("a*");
+            DecisionProcedureCUT proc(equalities, init_ass, { }, m, m_util_s, m_util_a);
+            proc.set_event_log(&log);
+            proc.init_computation();
+            CHECK(proc.compute_next_solution());
+        }
+
+        std::ifstream in(path, std::ios::binary);
+        char magic[sizeof(EventLog::MAGIC)];
+        REQUIRE(in.read(magic, sizeof(magic)));
+        CHECK(std::memcmp(magic, EventLog::MAGIC, sizeof(magic)) == 0);
+        std::vector<Event> events;
+        Event ev;
+        while (in.read(reinterpret_cast<char*>(&ev), sizeof(ev))) {
+            events.push_back(ev);
+        }
+        REQUIRE(!events.empty());
+        // the initial state is pushed first, the found solution is popped last
+        CHECK(events.front().type == static_cast<uint8_t>(EventType::StatePush));
+        CHECK(events.front().state == 1);
+        CHECK(events.back().type == static_cast<uint8_t>(EventType::StatePop));
+        CHECK(events.back().result == 1);
+        std::filesystem::remove(path);
+    }
 }
@@ -749,3 +749,26 @@ TEST_CASE( "Remove extension", "[noodler]" ) {
         CHECK(prep.get_dependency().empty());
     }
 }
+
+TEST_CASE( "Length formula arena", "[noodler]" ) {
+    BasicTerm x1{ BasicTermType::Variable, "x_1"};
+    BasicTerm x2{ BasicTermType::Variable, "x_2"};
+    LenNodeArena arena;
+
+    SECTION("hash-consing") {
+        CHECK(arena.mk_leaf(x1) == arena.mk_leaf(x1));
+        CHECK(arena.mk_leaf(x1) != arena.mk_leaf(x2));
+        CHECK(arena.mk_num(0) == arena.mk_num(0));
+        CHECK(arena.size() == 3);
+    }
+
+    SECTION("shared equations") {
+        Predicate eq(PredicateType::Equation, std::vector<std::vector<BasicTerm>>({ std::vector<BasicTerm>({x1, x2}), std::vector<BasicTerm>({x2}) }));
+        const LenNode* f1 = eq.get_formula_eq(arena);
+        const LenNode* f2 = eq.get_formula_eq(arena);
+        CHECK(f1 == f2);
+        CHECK(f1->type == LenFormulaType::EQ);
+        CHECK(f1->succ[0]->succ[1] == f1->succ[1]); // the leaf |x_2| is shared
+        CHECK(arena.size() == 4);
+    }
+}
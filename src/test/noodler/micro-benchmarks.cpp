@@ -0,0 +1,191 @@
+/**
+ * Microbenchmarks of the primitives the noodler decision procedure relies on.
+ *
+ * The benchmarks are built into a separate binary (bench-noodler-micro), run them using
+ *  ./bench-noodler-micro                          (human readable summary)
+ *  ./bench-noodler-micro --reporter xml::out=micro.xml
+ *  ./bench-noodler-micro --reporter JSON::out=micro.json   (Catch2 >= 3.5)
+ * Each benchmark is parameterized by the size of its input, which is part of its name. A single
+ * primitive can be selected by the test case name, e.g. ./bench-noodler-micro "SolvingState::substitute_vars()".
+ */
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <mata/nfa-strings.hh>
+#include <mata/re2parser.hh>
+
+#include "smt/theory_str_noodler/aut_assignment.h"
+#include "smt/theory_str_noodler/decision_procedure.h"
+#include "smt/theory_str_noodler/formula_preprocess.h"
+#include "smt/theory_str_noodler/util.h"
+#include "smt/params/theory_str_noodler_params.h"
+#include "ast/reg_decl_plugins.h"
+
+using namespace smt::noodler;
+
+namespace {
+
+    std::shared_ptr<Mata::Nfa::Nfa> bench_regex_to_nfa(const std::string& regex) {
+        Mata::Nfa::Nfa aut;
+        Mata::RE2Parser::create_nfa(&aut, regex);
+        return std::make_shared<Mata::Nfa::Nfa>(aut);
+    }
+
+    BasicTerm bench_var(const std::string& prefix, size_t i) {
+        return { BasicTermType::Variable, prefix + "_" + std::to_string(i) };
+    }
+
+    std::string sized_name(const std::string& name, size_t size) {
+        return name + "/" + std::to_string(size);
+    }
+
+    /**
+     * @brief Synthetic formula x_i = x_{i+1} y_i (0 <= i < n) with every variable restricted to (a|b)*
+     *  and y_i additionally to (ab)*.
+     */
+    std::pair<Formula, AutAssignment> chain_formula(size_t n) {
+        Formula formula;
+        AutAssignment aut_ass;
+        for (size_t i = 0; i < n; ++i) {
+            formula.add_predicate(Predicate(PredicateType::Equation, std::vector<std::vector<BasicTerm>>{
+                { bench_var("x", i) }, { bench_var("x", i + 1), bench_var("y", i) } }));
+            aut_ass[bench_var("x", i)] = bench_regex_to_nfa("(a|b)*");
+            aut_ass[bench_var("y", i)] = bench_regex_to_nfa("(ab)*");
+        }
+        aut_ass[bench_var("x", n)] = bench_regex_to_nfa("(a|b)*");
+        return { formula, aut_ass };
+    }
+}
+
+TEST_CASE("util::conv_to_nfa()", "[noodler][benchmark]") {
+    ast_manager m;
+    reg_decl_plugins(m);
+    seq_util m_util_s(m);
+    const std::set<uint32_t> alphabet{ 'a', 'b', 'c' };
+    const size_t size = GENERATE(2, 4, 8, 16);
+
+    expr_ref a(m_util_s.re.mk_to_re(m_util_s.str.mk_string("a")), m);
+    expr_ref b(m_util_s.re.mk_to_re(m_util_s.str.mk_string("b")), m);
+    expr_ref a_or_b(m_util_s.re.mk_union(a, b), m);
+
+    // (a|b)* a (a|b)^size: small NFA, exponential DFA
+    expr_ref suffix(m_util_s.re.mk_concat(m_util_s.re.mk_star(a_or_b), a), m);
+    for (size_t i = 0; i < size; ++i) {
+        suffix = m_util_s.re.mk_concat(suffix, a_or_b);
+    }
+    BENCHMARK(sized_name("suffix", size)) {
+        return util::conv_to_nfa(to_app(suffix), m_util_s, m, alphabet);
+    };
+    BENCHMARK(sized_name("suffix-complement", size)) {
+        return util::conv_to_nfa(to_app(suffix), m_util_s, m, alphabet, true);
+    };
+
+    // union of size distinct literals
+    expr_ref literals(m_util_s.re.mk_to_re(m_util_s.str.mk_string("c")), m);
+    for (size_t i = 0; i < size; ++i) {
+        std::string word(i + 1, 'a');
+        word += "b";
+        literals = m_util_s.re.mk_union(literals, m_util_s.re.mk_to_re(m_util_s.str.mk_string(word.c_str())));
+    }
+    BENCHMARK(sized_name("literal-union", size)) {
+        return util::conv_to_nfa(to_app(literals), m_util_s, m, alphabet);
+    };
+}
+
+TEST_CASE("AutAssignment::get_automaton_concat()", "[noodler][benchmark]") {
+    const size_t size = GENERATE(2, 8, 32, 64);
+    AutAssignment aut_ass;
+    std::vector<BasicTerm> concat;
+    for (size_t i = 0; i < size; ++i) {
+        aut_ass[bench_var("x", i)] = bench_regex_to_nfa("(ab)*c");
+        concat.push_back(bench_var("x", i));
+    }
+
+    BENCHMARK(sized_name("concat", size)) {
+        return aut_ass.get_automaton_concat(concat);
+    };
+}
+
+TEST_CASE("Mata::Strings::SegNfa::noodlify_for_equation()", "[noodler][benchmark]") {
+    const size_t left_size = GENERATE(1, 2, 4);
+    const size_t right_size = GENERATE(1, 2, 3);
+
+    std::vector<std::shared_ptr<Mata::Nfa::Nfa>> left_side;
+    for (size_t i = 0; i < left_size; ++i) {
+        left_side.push_back(bench_regex_to_nfa("(a|b)*"));
+    }
+    std::vector<std::shared_ptr<Mata::Nfa::Nfa>> right_side;
+    for (size_t i = 0; i < right_size; ++i) {
+        right_side.push_back(bench_regex_to_nfa(i % 2 == 0 ? "a*b" : "(ab)*"));
+    }
+
+    BENCHMARK(sized_name(sized_name("noodlify", left_size), right_size)) {
+        return Mata::Strings::SegNfa::noodlify_for_equation(left_side, right_side, false, {{"reduce", "true"}});
+    };
+}
+
+TEST_CASE("SolvingState::substitute_vars()", "[noodler][benchmark]") {
+    const size_t size = GENERATE(8, 64, 256);
+
+    SolvingState state;
+    std::unordered_map<BasicTerm, std::vector<BasicTerm>> substitution_map;
+    for (size_t i = 0; i < size; ++i) {
+        Predicate inclusion(PredicateType::Equation, std::vector<std::vector<BasicTerm>>{
+            { bench_var("x", i), bench_var("x", i + 1) }, { bench_var("y", i) } });
+        state.inclusions.insert(inclusion);
+        state.inclusions_to_process.push_back(inclusion);
+        if (i % 2 == 0) {
+            state.inclusions_not_on_cycle.insert(inclusion);
+            substitution_map[bench_var("x", i)] = { bench_var("z", i), bench_var("z", i + 1) };
+        }
+    }
+
+    BENCHMARK_ADVANCED(sized_name("substitute", size))(Catch::Benchmark::Chronometer meter) {
+        std::vector<SolvingState> states(meter.runs(), state);
+        meter.measure([&](int i) { states[i].substitute_vars(substitution_map); });
+    };
+}
+
+TEST_CASE("FormulaPreprocess passes", "[noodler][benchmark]") {
+    const theory_str_noodler_params params;
+    const size_t size = GENERATE(4, 16, 64);
+    const auto instance = chain_formula(size);
+    const Formula& formula = instance.first;
+    const AutAssignment& aut_ass = instance.second;
+
+    // each run gets its own freshly constructed preprocessor, only the pass itself is measured
+    auto bench_pass = [&](Catch::Benchmark::Chronometer& meter, const std::function<void(FormulaPreprocess&)>& pass) {
+        std::vector<FormulaPreprocess> preps;
+        preps.reserve(meter.runs());
+        for (int i = 0; i < meter.runs(); ++i) {
+            preps.emplace_back(formula, aut_ass, std::unordered_set<BasicTerm>{}, params);
+        }
+        meter.measure([&](int i) { pass(preps[i]); });
+    };
+
+    BENCHMARK(sized_name("construct", size)) {
+        return FormulaPreprocess(formula, aut_ass, {}, params);
+    };
+    BENCHMARK_ADVANCED(sized_name("propagate_variables", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.propagate_variables(); });
+    };
+    BENCHMARK_ADVANCED(sized_name("remove_regular", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.remove_regular(); });
+    };
+    BENCHMARK_ADVANCED(sized_name("generate_identities", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.generate_identities(); });
+    };
+    BENCHMARK_ADVANCED(sized_name("reduce_regular_sequence", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.reduce_regular_sequence(2); });
+    };
+    BENCHMARK_ADVANCED(sized_name("separate_eqs", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.separate_eqs(); });
+    };
+    BENCHMARK_ADVANCED(sized_name("remove_extension", size))(Catch::Benchmark::Chronometer meter) {
+        bench_pass(meter, [](FormulaPreprocess& prep) { prep.remove_extension(); });
+    };
+}
@@ -0,0 +1,171 @@
+/**
+ * Regression tests running whole SMT-LIB2 problems through the Z3 API with the noodler string solver.
+ */
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "api/z3.h"
+
+namespace {
+
+    /**
+     * @brief Solver with the noodler string solver enabled, the assertions are given as SMT-LIB2 scripts.
+     */
+    class NoodlerSolver {
+        Z3_context ctx;
+        Z3_solver solver;
+
+    public:
+        explicit NoodlerSolver(const std::vector<std::pair<std::string, std::string>>& params = {}) {
+            Z3_global_param_set("smt.string_solver", "noodler");
+            for(const auto& [name, value] : params) {
+                Z3_global_param_set(name.c_str(), value.c_str());
+            }
+            Z3_config cfg = Z3_mk_config();
+            Z3_set_param_value(cfg, "model", "true");
+            ctx = Z3_mk_context(cfg);
+            Z3_del_config(cfg);
+            solver = Z3_mk_solver(ctx);
+            Z3_solver_inc_ref(ctx, solver);
+        }
+
+        ~NoodlerSolver() {
+            Z3_solver_dec_ref(ctx, solver);
+            Z3_del_context(ctx);
+            Z3_global_param_reset_all();
+        }
+
+        void add(const std::string& smt2) { Z3_solver_from_string(ctx, solver, smt2.c_str()); }
+        void push() { Z3_solver_push(ctx, solver); }
+        void pop() { Z3_solver_pop(ctx, solver, 1); }
+        Z3_lbool check() { return Z3_solver_check(ctx, solver); }
+
+        /**
+         * @brief Get the value of the statistic @p key (0 if it is missing).
+         */
+        unsigned stat(const std::string& key) {
+            Z3_stats stats = Z3_solver_get_statistics(ctx, solver);
+            Z3_stats_inc_ref(ctx, stats);
+            unsigned res = 0;
+            for(unsigned i = 0; i < Z3_stats_size(ctx, stats); ++i) {
+                if(Z3_stats_is_uint(ctx, stats, i) && key == Z3_stats_get_key(ctx, stats, i)) {
+                    res = Z3_stats_get_uint_value(ctx, stats, i);
+                }
+            }
+            Z3_stats_dec_ref(ctx, stats);
+            return res;
+        }
+
+        /**
+         * @brief Check that the model of the last (sat) check satisfies all assertions.
+         */
+        bool model_satisfies_assertions() {
+            Z3_model model = Z3_solver_get_model(ctx, solver);
+            Z3_model_inc_ref(ctx, model);
+            Z3_ast_vector assertions = Z3_solver_get_assertions(ctx, solver);
+            Z3_ast_vector_inc_ref(ctx, assertions);
+            bool res = true;
+            for(unsigned i = 0; i < Z3_ast_vector_size(ctx, assertions) && res; ++i) {
+                Z3_ast val = nullptr;
+                res = Z3_model_eval(ctx, model, Z3_ast_vector_get(ctx, assertions, i), true, &val) &&
+                    Z3_get_bool_value(ctx, val) == Z3_L_TRUE;
+            }
+            Z3_ast_vector_dec_ref(ctx, assertions);
+            Z3_model_dec_ref(ctx, model);
+            return res;
+        }
+    };
+
+    const std::string decls = "(declare-fun a () String) (declare-fun t () String)";
+}
+
+TEST_CASE("Postponed replace axioms after pop", "[noodler]") {
+    NoodlerSolver s;
+    // the axioms of replace for the case (str.contains a "b") are postponed until the atom is true
+    s.add(decls + "(assert (= t (str.replace a \"b\" \"c\")))");
+    CHECK(s.check() == Z3_L_TRUE);
+
+    s.push();
+    s.add(decls + "(assert (str.contains a \"b\"))");
+    CHECK(s.check() == Z3_L_TRUE);
+    s.pop();
+
+    // the postponed axioms were added and deleted in the popped scope, they must be added again
+    s.push();
+    s.add(decls + "(assert (str.contains a \"b\")) (assert (= t a))");
+    CHECK(s.check() == Z3_L_FALSE);
+    s.pop();
+}
+
+TEST_CASE("Postponed replace axioms are registered once", "[noodler]") {
+    NoodlerSolver s;
+    // the replace term becomes relevant again in every scope, its postponed axioms must not pile up
+    for(unsigned i = 0; i < 5; ++i) {
+        s.push();
+        s.add(decls + "(assert (= t (str.replace a \"b\" \"c\")))");
+        CHECK(s.check() == Z3_L_TRUE);
+        s.pop();
+    }
+    s.push();
+    s.add(decls + "(assert (= t (str.replace a \"b\" \"c\"))) (assert (str.contains a \"b\"))");
+    CHECK(s.check() == Z3_L_TRUE);
+    CHECK(s.stat("str lazy axioms") <= 1);
+    s.pop();
+}
+
+TEST_CASE("Shared shapes after pop", "[noodler]") {
+    NoodlerSolver s;
+    s.add(decls + "(declare-fun i () Int)");
+    s.push();
+    s.add(decls + "(declare-fun i () Int) (assert (= t (str.substr a i 2)))");
+    CHECK(s.check() == Z3_L_TRUE);
+    s.pop();
+
+    // the prefix of a of length i shared with the substr term lost its axioms in the popped scope
+    s.add(decls + "(declare-fun i () Int) (assert (= (str.at a i) \"x\")) (assert (= a \"yy\"))");
+    CHECK(s.check() == Z3_L_FALSE);
+}
+
+TEST_CASE("Models of the euf plugin", "[noodler]") {
+    NoodlerSolver s({ std::make_pair("sat.euf", "true") });
+
+    SECTION("ground") {
+        s.add(decls + "(assert (= a \"ab\")) (assert (= t (str.++ a \"c\")))");
+        REQUIRE(s.check() == Z3_L_TRUE);
+        CHECK(s.model_satisfies_assertions());
+    }
+
+    SECTION("non-ground") {
+        // the decision procedure does not produce words, they are found by the bounded search
+        s.add(decls + "(assert (= (str.++ a \"b\") (str.++ \"b\" t))) (assert (str.in_re a (re.+ (str.to_re \"b\"))))");
+        REQUIRE(s.check() == Z3_L_TRUE);
+        CHECK(s.model_satisfies_assertions());
+    }
+
+    SECTION("non-ground with lengths") {
+        // words refuted by the length constraints are not tried again
+        s.add(decls + "(assert (= (str.++ a \"b\") (str.++ \"b\" t))) (assert (str.in_re a (re.+ (str.to_re \"b\"))))");
+        s.add(decls + "(assert (= (str.len t) 3))");
+        REQUIRE(s.check() == Z3_L_TRUE);
+        CHECK(s.model_satisfies_assertions());
+    }
+}
+
+TEST_CASE("Mixed ground and symbolic constraints", "[noodler]") {
+    NoodlerSolver s;
+    // the ground equation is decided directly and dropped, the decision procedure gets only the residue
+    s.add(decls + "(assert (= a \"ab\"))");
+
+    SECTION("sat") {
+        s.add(decls + "(assert (= (str.++ t \"c\") (str.++ \"c\" t)))");
+        CHECK(s.check() == Z3_L_TRUE);
+    }
+
+    SECTION("unsat") {
+        s.add(decls + "(assert (= (str.++ t \"c\") (str.++ \"d\" t)))");
+        CHECK(s.check() == Z3_L_FALSE);
+    }
+}
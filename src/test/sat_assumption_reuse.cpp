@@ -0,0 +1,70 @@
+/*++
+
+Module Name:
+
+    sat_assumption_reuse.cpp
+
+Abstract:
+
+    Test that repeated checks of the incremental sat solver keep the
+    assignment of the assumptions when the assumptions are extended.
+
+--*/
+
+#include "sat/sat_solver/inc_sat_solver.h"
+#include "ast/reg_decl_plugins.h"
+#include "util/statistics.h"
+#include <cstring>
+#include <iostream>
+
+static unsigned num_reuses(solver& s) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (st.is_uint(i) && strcmp(st.get_key(i), "sat assumption reuse") == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+void tst_sat_assumption_reuse() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    params_ref p;
+    ref<solver> s = mk_inc_sat_solver(m, p);
+    unsigned n = 10;
+    expr_ref_vector xs(m), ys(m);
+    for (unsigned i = 0; i < n; ++i) {
+        xs.push_back(m.mk_const(symbol(std::string("x") + std::to_string(i)), m.mk_bool_sort()));
+        ys.push_back(m.mk_const(symbol(std::string("y") + std::to_string(i)), m.mk_bool_sort()));
+    }
+    for (unsigned i = 0; i + 1 < n; ++i) {
+        s->assert_expr(m.mk_or(m.mk_not(xs.get(i)), xs.get(i + 1)));
+        s->assert_expr(m.mk_or(xs.get(i), ys.get(i)));
+    }
+    // the literal of the user scope is assumed in every check besides the given assumptions
+    s->push();
+    s->assert_expr(m.mk_or(m.mk_not(ys.get(0)), ys.get(n - 1)));
+
+    expr_ref_vector asms(m);
+    for (unsigned i = 0; i < n; ++i) {
+        asms.push_back(m.mk_not(xs.get(n - 1 - i)));
+        ENSURE(s->check_sat(asms) == l_true);
+    }
+    std::cout << "reuses: " << num_reuses(*s) << "\n";
+    ENSURE(num_reuses(*s) == n - 1);
+
+    // dropping an assumption requires a fresh assumption level
+    asms.pop_back();
+    ENSURE(s->check_sat(asms) == l_true);
+    ENSURE(num_reuses(*s) == n - 1);
+
+    // so does adding a clause
+    asms.push_back(m.mk_not(xs.get(0)));
+    s->assert_expr(m.mk_or(ys.get(1), ys.get(2)));
+    ENSURE(s->check_sat(asms) == l_true);
+    ENSURE(num_reuses(*s) == n - 1);
+    asms.push_back(ys.get(3));
+    ENSURE(s->check_sat(asms) == l_true);
+    ENSURE(num_reuses(*s) == n);
+    s->pop(1);
+}
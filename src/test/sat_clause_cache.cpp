@@ -0,0 +1,118 @@
+/*++
+
+Module Name:
+
+    sat_clause_cache.cpp
+
+Abstract:
+
+    Test saving and loading learned clauses through the learned clause cache.
+
+--*/
+
+#include "sat/sat_solver.h"
+#include "util/statistics.h"
+#include "util/util.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static char const* s_cache_file = "sat_clause_cache_test.bin";
+
+static unsigned get_stat(sat::solver& s, char const* key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+// random 3-SAT problem close to the threshold, the same clauses for the same seed
+static void add_random(sat::solver& s, unsigned seed) {
+    random_gen r(seed);
+    unsigned num_vars = 150;
+    for (unsigned i = 0; i < num_vars; ++i)
+        s.mk_var(false, true);
+    sat::literal c[3];
+    for (unsigned i = 0; i < 4.2 * num_vars; ++i) {
+        for (unsigned j = 0; j < 3; ++j)
+            c[j] = sat::literal(r(num_vars), r(2) == 0);
+        s.mk_clause(3, c);
+    }
+}
+
+static std::string read_file() {
+    std::ifstream in(s_cache_file, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void tst_sat_clause_cache() {
+    std::remove(s_cache_file);
+    params_ref p;
+    p.set_sym("learned_cache.file", symbol(s_cache_file));
+    reslimit lim;
+
+    // save
+    lbool result;
+    {
+        sat::solver s(p, lim);
+        add_random(s, 1);
+        result = s.check();
+        s.save_clause_cache();
+        std::cout << "saved: " << get_stat(s, "sat clause cache saved") << "\n";
+        ENSURE(get_stat(s, "sat clause cache saved") > 0);
+    }
+    std::string saved = read_file();
+    ENSURE(!saved.empty());
+
+    // load
+    {
+        sat::solver s(p, lim);
+        add_random(s, 1);
+        ENSURE(s.check() == result);
+        std::cout << "loaded: " << get_stat(s, "sat clause cache loaded") << "\n";
+        ENSURE(get_stat(s, "sat clause cache loaded") > 0);
+    }
+
+    // copies of a solver neither load nor save the cache of their source
+    {
+        sat::solver s(p, lim);
+        add_random(s, 1);
+        sat::solver c(p, lim);
+        c.copy(s);
+        ENSURE(c.check() == result);
+        ENSURE(get_stat(c, "sat clause cache loaded") == 0);
+        c.save_clause_cache();
+        ENSURE(get_stat(c, "sat clause cache saved") == 0);
+    }
+
+    // clauses added after the first check do not match the fingerprint, nothing is saved
+    saved = read_file();
+    {
+        sat::solver s(p, lim);
+        add_random(s, 2);
+        s.check();
+        s.mk_clause(sat::literal(0, false), sat::literal(1, false));
+        s.check();
+        s.save_clause_cache();
+    }
+    ENSURE(read_file() == saved);
+
+    // a corrupted record is skipped
+    {
+        std::fstream f(s_cache_file, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(saved.size() / 2);
+        f.put(static_cast<char>(saved[saved.size() / 2] ^ 0x5a));
+    }
+    {
+        sat::solver s(p, lim);
+        add_random(s, 1);
+        ENSURE(s.check() == result);
+        ENSURE(get_stat(s, "sat clause cache loaded") == 0);
+    }
+    std::remove(s_cache_file);
+}
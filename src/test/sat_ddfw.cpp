@@ -0,0 +1,92 @@
+/*++
+
+Module Name:
+
+    sat_ddfw.cpp
+
+Abstract:
+
+    Test the bulk operations of ddfw: the AVX2 kernels agree with the scalar
+    ones, and the block-skipping selection of pick_var picks the same variable
+    as a linear scan.
+
+--*/
+
+#include "sat/sat_ddfw_simd.h"
+#include "util/util.h"
+#include "util/vector.h"
+#include <iostream>
+
+// variable selected by pick_var without skipping blocks.
+static unsigned select_linear(int const* rewards, unsigned const* vars, unsigned n, double lim) {
+    for (unsigned i = 0; i < n; ++i) {
+        if (rewards[vars[i]] > 0) {
+            lim -= rewards[vars[i]];
+            if (lim <= 0)
+                return i;
+        }
+    }
+    return n;
+}
+
+static void tst_kernels(random_gen& r, svector<int> const& rewards, unsigned n) {
+    unsigned_vector vars, num_trues, w1, w2;
+    for (unsigned i = 0; i < n; ++i) {
+        vars.push_back(r(rewards.size()));
+        num_trues.push_back(r(3));
+        w1.push_back(r(100));
+    }
+    w2.append(w1);
+    int64_t sum = sat::simd::scalar::sum_pos(rewards.data(), vars.data(), n);
+    ENSURE(sat::simd::sum_pos(rewards.data(), vars.data(), n) == sum);
+    sat::simd::scalar::inc_all(w1.data(), n);
+    sat::simd::inc_all(w2.data(), n);
+    ENSURE(w1 == w2);
+    sat::simd::scalar::reset_weights(w1.data(), num_trues.data(), n, 7);
+    sat::simd::reset_weights(w2.data(), num_trues.data(), n, 7);
+    ENSURE(w1 == w2);
+#ifdef Z3_DDFW_AVX2
+    if (sat::simd::has_avx2()) {
+        ENSURE(sat::simd::avx2::sum_pos(rewards.data(), vars.data(), n) == sum);
+        sat::simd::avx2::inc_all(w2.data(), n);
+        sat::simd::scalar::inc_all(w1.data(), n);
+        ENSURE(w1 == w2);
+        sat::simd::avx2::reset_weights(w2.data(), num_trues.data(), n, 3);
+        sat::simd::scalar::reset_weights(w1.data(), num_trues.data(), n, 3);
+        ENSURE(w1 == w2);
+    }
+#endif
+}
+
+static void tst_select(random_gen& r, svector<int> const& rewards, unsigned n) {
+    unsigned_vector vars;
+    for (unsigned i = 0; i < n; ++i)
+        vars.push_back(r(rewards.size()));
+    double sum = static_cast<double>(sat::simd::sum_pos(rewards.data(), vars.data(), n));
+    for (unsigned k = 0; k < 100; ++k) {
+        // the limit drawn by pick_var
+        double lim = ((double) r() / (1.0 + r.max_value())) * sum;
+        ENSURE(sat::simd::select_pos(rewards.data(), vars.data(), n, lim) == select_linear(rewards.data(), vars.data(), n, lim));
+    }
+    // the limit is reached exactly at the end of blocks
+    double lim = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        if (rewards[vars[i]] > 0)
+            lim += rewards[vars[i]];
+        if (i % sat::simd::block_size == sat::simd::block_size - 1)
+            ENSURE(sat::simd::select_pos(rewards.data(), vars.data(), n, lim) == select_linear(rewards.data(), vars.data(), n, lim));
+    }
+    ENSURE(sat::simd::select_pos(rewards.data(), vars.data(), n, sum + 1) == n);
+}
+
+void tst_sat_ddfw() {
+    random_gen r(0);
+    svector<int> rewards;
+    for (unsigned v = 0; v < 1000; ++v)
+        rewards.push_back(static_cast<int>(r(101)) - 50);
+    std::cout << "avx2: " << sat::simd::has_avx2() << "\n";
+    for (unsigned n : { 0u, 1u, 7u, 8u, 9u, 63u, 64u, 65u, 200u, 1000u })
+        tst_kernels(r, rewards, n);
+    for (unsigned n : { 10u, 64u, 130u, 500u, 2000u })
+        tst_select(r, rewards, n);
+}
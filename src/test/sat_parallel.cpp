@@ -0,0 +1,66 @@
+/*++
+
+Module Name:
+
+    sat_parallel.cpp
+
+Abstract:
+
+    Test the exchange of clauses and units between parallel sat solvers.
+    Clauses go through fixed size rings and may be dropped when a ring
+    wraps around, units must always arrive.
+
+--*/
+
+#include "sat/sat_parallel.h"
+#include "sat/sat_solver.h"
+#include "util/util.h"
+#include <iostream>
+
+void tst_sat_parallel() {
+    params_ref p;
+    p.set_uint("threads", 2);
+    reslimit lim;
+    unsigned num_vars = 200;
+    sat::solver s0(p, lim), s1(p, lim);
+    for (unsigned v = 0; v < num_vars; ++v) {
+        s0.mk_var(false, true);
+        s1.mk_var(false, true);
+    }
+    sat::parallel par(s0);
+    // a small ring, the clauses below wrap around it many times
+    par.reserve(2, 64);
+    s0.set_par(&par, 0);
+    s1.set_par(&par, 1);
+
+    random_gen r(0);
+    auto flood = [&]() {
+        for (unsigned i = 0; i < 1000; ++i)
+            par.share_clause(s0, sat::literal(r(num_vars), r(2) == 0), sat::literal(r(num_vars), r(2) == 0));
+    };
+
+    unsigned limit0 = 0, limit1 = 0;
+    sat::literal_vector units, in, out;
+    for (unsigned round = 0; round < 10; ++round) {
+        flood();
+        out.reset();
+        for (unsigned i = 0; i < 10; ++i)
+            out.push_back(sat::literal(10 * round + i, (round + i) % 2 == 0));
+        units.append(out);
+        par.exchange(s0, out, limit0, in);
+        ENSURE(in.empty());
+        flood();
+    }
+
+    // s1 fell behind by much more than the capacity of the ring
+    par.get_clauses(s1);
+    in.reset();
+    out.reset();
+    par.exchange(s1, out, limit1, in);
+    std::cout << "units: " << units.size() << " received: " << in.size() << "\n";
+    for (sat::literal lit : units)
+        ENSURE(in.contains(lit));
+
+    s0.set_par(nullptr, 0);
+    s1.set_par(nullptr, 0);
+}
@@ -5,7 +5,86 @@ Copyright (c) 2015 Microsoft Corporation
 --*/
 
 #include "smt/smt_context.h"
+#include "smt/smt_lookahead.h"
 #include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/seq_decl_plugin.h"
+#include "ast/ast_translation.h"
+#include "ast/ast_util.h"
+
+// pigeon hole problem over integers: n + 1 pairwise distinct values in [0, n)
+static void assert_int_php(ast_manager& m, smt::context& ctx, unsigned n) {
+    arith_util a(m);
+    expr_ref_vector xs(m);
+    for (unsigned i = 0; i <= n; ++i) {
+        xs.push_back(m.mk_const(symbol(("x" + std::to_string(i)).c_str()), a.mk_int()));
+        ctx.assert_expr(a.mk_ge(xs.get(i), a.mk_int(0)));
+        ctx.assert_expr(a.mk_lt(xs.get(i), a.mk_int(n)));
+    }
+    for (unsigned i = 0; i <= n; ++i)
+        for (unsigned j = i + 1; j <= n; ++j)
+            ctx.assert_expr(m.mk_or(a.mk_lt(xs.get(i), xs.get(j)), a.mk_gt(xs.get(i), xs.get(j))));
+}
+
+// lemmas exported by one context are valid in a context of another manager (see smt::parallel)
+static void tst_lemma_outbox() {
+    smt_params params;
+    ast_manager m1, m2;
+    reg_decl_plugins(m1);
+    reg_decl_plugins(m2);
+    smt::context ctx1(m1, params), ctx2(m2, params);
+    vector<expr_ref_vector> outbox;
+    ctx1.set_lemma_outbox(&outbox);
+    assert_int_php(m1, ctx1, 4);
+    ENSURE(ctx1.check() == l_false);
+    ENSURE(!outbox.empty());
+
+    ast_translation tr(m1, m2);
+    assert_int_php(m2, ctx2, 4);
+    for (expr_ref_vector const& cls : outbox) {
+        ENSURE(cls.size() >= 2 && cls.size() <= params.m_threads_share_size);
+        expr_ref lemma = mk_or(cls);
+        ctx2.assert_expr(tr(lemma.get()));
+    }
+    ENSURE(ctx2.check() == l_false);
+    ctx1.set_lemma_outbox(nullptr);
+}
+
+// with threads.cube_strings, string atoms are flagged at internalization and the lookahead chooses only among them
+static void tst_string_lookahead() {
+    smt_params params;
+    params.m_threads_cube_strings = true;
+    params.m_string_solver = symbol("seq");
+    ast_manager m;
+    reg_decl_plugins(m);
+    seq_util su(m);
+    arith_util a(m);
+    smt::context ctx(m, params);
+    expr_ref x(m.mk_const(symbol("x"), su.mk_string_sort()), m);
+    expr_ref y(m.mk_const(symbol("y"), su.mk_string_sort()), m);
+    expr_ref p(m.mk_const(symbol("p"), m.mk_bool_sort()), m);
+    expr_ref q(m.mk_const(symbol("q"), m.mk_bool_sort()), m);
+    expr_ref a_star(su.re.mk_star(su.re.mk_to_re(su.str.mk_string("a"))), m);
+    ctx.assert_expr(m.mk_or(p, q));
+    ctx.assert_expr(m.mk_or(m.mk_eq(x, su.str.mk_string("ab")), su.re.mk_in_re(x, a_star)));
+    ctx.assert_expr(m.mk_or(q, a.mk_le(a.mk_add(su.str.mk_length(y), a.mk_int(1)), a.mk_int(3))));
+    ENSURE(ctx.check() == l_true);
+
+    unsigned num_string_atoms = 0;
+    for (smt::bool_var v = 0; v < static_cast<smt::bool_var>(ctx.get_num_bool_vars()); ++v) {
+        expr* e = ctx.bool_var2expr(v);
+        if (!e)
+            continue;
+        ENSURE(ctx.get_bdata(v).m_string_atom == smt::lookahead::is_string_atom(m, e));
+        num_string_atoms += ctx.get_bdata(v).m_string_atom;
+    }
+    ENSURE(num_string_atoms >= 3);
+    ENSURE(!smt::lookahead::is_string_atom(m, p));
+
+    smt::lookahead lh(ctx, true);
+    expr_ref c = lh.choose();
+    ENSURE(m.is_true(c) || smt::lookahead::is_string_atom(m, c));
+}
 
 void tst_smt_context()
 {
@@ -34,4 +113,7 @@ void tst_smt_context()
     }
 
     ctx.check();
+
+    tst_lemma_outbox();
+    tst_string_lookahead();
 }
@@ -0,0 +1,85 @@
+// test driver for the shared thread pool.
+// run nested groups of tasks on pools of different sizes.
+
+#include "util/thread_pool.h"
+#include "util/debug.h"
+#include "util/rlimit.h"
+#include "util/z3_exception.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+static void tst_nested(unsigned num_threads) {
+    thread_pool::set_num_threads(num_threads);
+    std::atomic<unsigned> count(0);
+    for (unsigned r = 0; r < 20; ++r) {
+        thread_pool::run(8, [&](unsigned i) {
+            thread_pool::run(4, [&](unsigned j) {
+                thread_pool::run(2, [&](unsigned k) { ++count; });
+            });
+        });
+    }
+    ENSURE(count == 20 * 8 * 4 * 2);
+}
+
+static void tst_exception() {
+    bool thrown = false;
+    try {
+        thread_pool::run(4, [&](unsigned i) { if (i == 3) throw default_exception("task failed"); });
+    }
+    catch (z3_exception&) {
+        thrown = true;
+    }
+    ENSURE(thrown);
+}
+
+// groups with more tasks than workers run on the workers and the calling thread only.
+static void tst_bounded(unsigned num_threads, unsigned n) {
+    thread_pool::set_num_threads(num_threads);
+    std::mutex mux;
+    std::set<std::thread::id> ids;
+    std::atomic<unsigned> count(0);
+    thread_pool::run(n, [&](unsigned i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++count;
+        std::lock_guard<std::mutex> lock(mux);
+        ids.insert(std::this_thread::get_id());
+    });
+    ENSURE(count == n);
+    ENSURE(ids.size() <= num_threads + 1);
+}
+
+// tasks that have not started when the limit is canceled are skipped.
+static void tst_cancel() {
+    thread_pool::set_num_threads(1);
+    reslimit lim;
+    unsigned n = 64;
+    std::atomic<unsigned> executed(0);
+    thread_pool::run(n, [&](unsigned i) {
+        if (i == 0) {
+            lim.cancel();
+            return;
+        }
+        ++executed;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }, &lim);
+    std::cout << "executed after cancel: " << executed << "\n";
+    ENSURE(executed < n - 1);
+}
+
+void tst_thread_pool() {
+    std::cout << "nested groups\n";
+    tst_nested(1);
+    tst_nested(4);
+    std::cout << "bounded pool\n";
+    tst_bounded(1, 8);
+    tst_bounded(2, 32);
+    std::cout << "cancellation\n";
+    tst_cancel();
+    std::cout << "exceptions\n";
+    tst_exception();
+    thread_pool::set_num_threads(0);
+}
@@ -21,6 +21,7 @@ Notes:
 #include "util/gparams.h"
 #include "util/util.h"
 #include "util/memory_manager.h"
+#include "util/thread_pool.h"
 
 void env_params::updt_params() {
     params_ref const& p = gparams::get_ref();
@@ -32,6 +33,7 @@ void env_params::updt_params() {
     unsigned mb = p.get_uint("memory_high_watermark_mb", 0);
     if (mb > 0)
         memory::set_high_watermark(megabytes_to_bytes(mb));    
+    thread_pool::set_num_threads(p.get_uint("thread_pool_size", 0));
 }
 
 void env_params::collect_param_descrs(param_descrs & d) {
@@ -41,4 +43,5 @@ void env_params::collect_param_descrs(param_descrs & d) {
     d.insert("memory_max_alloc_count", CPK_UINT, "set hard upper limit for memory allocations, if 0 then there is no limit", "0");
     d.insert("memory_high_watermark", CPK_UINT, "set high watermark for memory consumption (in bytes), if 0 then there is no limit", "0");
     d.insert("memory_high_watermark_mb", CPK_UINT, "set high watermark for memory consumption (in megabytes), if 0 then there is no limit", "0");
+    d.insert("thread_pool_size", CPK_UINT, "number of worker threads shared by parallel solvers and tactics, if 0 then the number of hardware threads is used", "0");
 }
@@ -0,0 +1,196 @@
+/*++
+
+Module Name:
+
+    thread_pool.cpp
+
+Abstract:
+
+    Process-wide pool of worker threads shared by the parallel solvers and tactics.
+
+--*/
+
+#include "util/thread_pool.h"
+#include "util/rlimit.h"
+
+#ifdef SINGLE_THREAD
+
+void thread_pool::run(unsigned n, task const& f, reslimit* lim) {
+    for (unsigned i = 0; i < n && !(lim && lim->is_canceled()); ++i)
+        f(i);
+}
+
+void thread_pool::set_num_threads(unsigned n) {}
+
+void thread_pool::finalize() {}
+
+#else
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct task_group {
+        thread_pool::task const& m_fn;
+        reslimit*                m_limit;
+        unsigned                 m_pending;
+        std::mutex               m_mutex;
+        std::condition_variable  m_cv;
+        std::exception_ptr       m_exception;
+        task_group(thread_pool::task const& f, reslimit* lim, unsigned n): m_fn(f), m_limit(lim), m_pending(n) {}
+    };
+
+    struct pool_task {
+        task_group* m_group;
+        unsigned    m_idx;
+    };
+
+    struct pool_state {
+        std::vector<std::thread>  m_workers;
+        std::mutex                m_mutex;
+        std::condition_variable   m_cv;
+        std::deque<pool_task>     m_tasks;
+        bool                      m_shutdown { false };
+    };
+
+    std::mutex        g_pool_mutex;
+    pool_state*       g_pool = nullptr;
+    unsigned          g_num_threads = 0;   // requested size, 0 for the number of hardware threads
+    unsigned          g_active_groups = 0;
+
+    void execute(pool_task const& t) {
+        task_group& g = *t.m_group;
+        try {
+            // cooperative cancellation: tasks that have not started yet are dropped.
+            if (!g.m_limit || !g.m_limit->is_canceled())
+                g.m_fn(t.m_idx);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(g.m_mutex);
+            if (!g.m_exception)
+                g.m_exception = std::current_exception();
+        }
+        // the group may be destroyed once m_pending reaches 0 and the lock is released.
+        std::lock_guard<std::mutex> lock(g.m_mutex);
+        if (--g.m_pending == 0)
+            g.m_cv.notify_all();
+    }
+
+    /**
+       \brief Remove a queued task of the given group.
+    */
+    bool try_steal(pool_state& p, task_group const* group, pool_task& t) {
+        std::lock_guard<std::mutex> lock(p.m_mutex);
+        for (auto it = p.m_tasks.begin(); it != p.m_tasks.end(); ++it) {
+            if (it->m_group == group) {
+                t = *it;
+                p.m_tasks.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(pool_state* p) {
+        std::unique_lock<std::mutex> lock(p->m_mutex);
+        while (true) {
+            p->m_cv.wait(lock, [&]() { return !p->m_tasks.empty() || p->m_shutdown; });
+            if (p->m_tasks.empty())
+                return;
+            pool_task t = p->m_tasks.front();
+            p->m_tasks.pop_front();
+            lock.unlock();
+            execute(t);
+            lock.lock();
+        }
+    }
+
+    void stop_pool() {
+        if (!g_pool)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(g_pool->m_mutex);
+            g_pool->m_shutdown = true;
+        }
+        g_pool->m_cv.notify_all();
+        for (std::thread& th : g_pool->m_workers)
+            th.join();
+        delete g_pool;
+        g_pool = nullptr;
+    }
+
+    /**
+       \brief Start the pool or resize it if it is idle. Called with g_pool_mutex held.
+    */
+    pool_state& ensure_pool() {
+        unsigned n = g_num_threads;
+        if (n == 0)
+            n = std::max(1u, std::thread::hardware_concurrency());
+        if (g_pool && g_pool->m_workers.size() != n && g_active_groups == 0)
+            stop_pool();
+        if (!g_pool) {
+            g_pool = new pool_state();
+            for (unsigned i = 0; i < n; ++i)
+                g_pool->m_workers.push_back(std::thread(worker_loop, g_pool));
+        }
+        return *g_pool;
+    }
+
+}
+
+void thread_pool::run(unsigned n, task const& f, reslimit* lim) {
+    if (n == 0)
+        return;
+    pool_state* p;
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        p = &ensure_pool();
+        ++g_active_groups;
+    }
+    task_group g(f, lim, n);
+    if (n > 1) {
+        {
+            std::lock_guard<std::mutex> lock(p->m_mutex);
+            for (unsigned i = 1; i < n; ++i)
+                p->m_tasks.push_back(pool_task{ &g, i });
+        }
+        p->m_cv.notify_all();
+    }
+
+    // run the first task and then the tasks of the group that no worker has taken yet.
+    // The calling thread never runs tasks of other groups, so it does not get stuck in
+    // unrelated work while its own group is done.
+    execute(pool_task{ &g, 0 });
+    pool_task t;
+    while (try_steal(*p, &g, t))
+        execute(t);
+    {
+        std::unique_lock<std::mutex> lock(g.m_mutex);
+        g.m_cv.wait(lock, [&]() { return g.m_pending == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        --g_active_groups;
+    }
+    if (g.m_exception)
+        std::rethrow_exception(g.m_exception);
+}
+
+void thread_pool::set_num_threads(unsigned n) {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    g_num_threads = n;
+}
+
+void thread_pool::finalize() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (g_active_groups == 0)
+        stop_pool();
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*++
+
+Module Name:
+
+    thread_pool.h
+
+Abstract:
+
+    Process-wide pool of worker threads shared by the parallel solvers and tactics.
+
+    Parallel work is submitted as a group of n tasks through thread_pool::run, which
+    returns when all tasks of the group are done. The pool has a fixed number of
+    workers: the calling thread executes the first task and then takes the queued
+    tasks of its own group, the workers take queued tasks of any group. A group can
+    therefore complete on the calling thread alone, and nested groups cannot deadlock.
+    Tasks that have not started when the resource limit of their group is canceled
+    are skipped. Tasks of a group may run one after the other, so a task must not
+    wait for a sibling unless the sibling can also finish on its own, e.g., portfolio
+    members that stop early once a sibling cancels them.
+
+--*/
+#pragma once
+
+#include <functional>
+
+class reslimit;
+
+class thread_pool {
+public:
+    typedef std::function<void(unsigned)> task;
+
+    /**
+       \brief Execute f(0), ..., f(n-1) concurrently and wait for their completion.
+       The first exception thrown by a task is rethrown after all tasks are done.
+       Tasks that have not started when lim is canceled are not executed.
+    */
+    static void run(unsigned n, task const& f, reslimit* lim = nullptr);
+
+    /**
+       \brief Set the number of worker threads, 0 uses the number of hardware threads.
+       The pool is resized the next time it is idle.
+    */
+    static void set_num_threads(unsigned n);
+
+    static void finalize();
+};
+
+/*
+    ADD_FINALIZER('thread_pool::finalize();')
+*/